@@ -1,25 +1,84 @@
 #include "Animation.h"
-#include "Engine.h"
 
-Animation::Animation(const char* animName)
+#include <stdexcept>
+
+Animation::Animation(const char* animName, AnimationClip&& clip) : m_Clip(std::move(clip))
+{
+	m_Name = animName;
+	m_keyFrameCount = m_Clip.getKeyCount();
+	m_duration = m_Clip.getDuration();
+	m_Timing = ClipTiming(m_keyFrameCount, m_duration);
+}
+
+Animation::Animation(const char* animName, CompressedClip&& clip) : m_CompressedClip(std::move(clip))
 {
 	m_Name = animName;
-	m_keyFrameCount = GetAnimKeyCount(animName);
-	m_animFrameTransforms.reserve(m_keyFrameCount);
+	m_keyFrameCount = m_CompressedClip.getKeyCount();
+	m_duration = m_CompressedClip.getDuration();
+	m_Timing = ClipTiming(m_keyFrameCount, m_duration);
+	m_isCompressed = true;
 }
 
-void Animation::initTransforms(size_t boneCount)
+void Animation::makeAdditive(Skeleton const& skeleton, std::span<Transform const> referencePose)
 {
-	for (int frame = 0; frame < m_keyFrameCount; frame++)
+	if (m_isAdditive)
 	{
-		m_animFrameTransforms.push_back(std::vector<Transform>(boneCount));
-		for (int boneIndex = 0; boneIndex < boneCount; boneIndex++)
-		{
-			GetAnimLocalBoneTransform(
-				m_Name, boneIndex, frame, m_animFrameTransforms[frame][boneIndex].m_Position.m_x,
-				m_animFrameTransforms[frame][boneIndex].m_Position.m_y, m_animFrameTransforms[frame][boneIndex].m_Position.m_z,
-				m_animFrameTransforms[frame][boneIndex].m_Rotation.m_a, m_animFrameTransforms[frame][boneIndex].m_Rotation.m_b,
-				m_animFrameTransforms[frame][boneIndex].m_Rotation.m_c, m_animFrameTransforms[frame][boneIndex].m_Rotation.m_d);
-		}
+		throw std::logic_error("Animation is already additive");
 	}
+
+	size_t				   boneCount = skeleton.m_boneCount;
+	std::vector<Transform> inverseReference(referencePose.begin(), referencePose.end());
+	std::vector<Transform> keys(m_keyFrameCount * boneCount);
+
+	LM_::invert(getRigidTransforms(inverseReference.data()), getRigidTransforms(inverseReference.data()), boneCount);
+	for (size_t key = 0; key < m_keyFrameCount; key++)
+	{
+		LM_::RigidTransforms pose = getRigidTransforms(keys.data() + key * boneCount);
+
+		getPose(key, keys.data() + key * boneCount);
+		LM_::compose(pose, getRigidTransforms(inverseReference.data()), pose, boneCount);
+	}
+
+	m_Clip = AnimationClip(keys.data(), m_keyFrameCount, boneCount, m_duration);
+	m_CompressedClip = CompressedClip();
+	m_isCompressed = false;
+	m_isAdditive = true;
+}
+
+void Animation::makeAdditive(Skeleton const& skeleton)
+{
+	std::vector<Transform> referencePose(skeleton.m_boneCount);
+
+	getPose(0, referencePose.data());
+	makeAdditive(skeleton, referencePose);
+}
+
+Transform Animation::getTransform(size_t boneIndex, size_t keyFrame) const
+{
+	return m_isCompressed ? m_CompressedClip.getTransform(boneIndex, keyFrame) : m_Clip.getTransform(boneIndex, keyFrame);
+}
+
+void Animation::getPose(size_t keyFrame, Transform* pose) const
+{
+	if (m_isCompressed)
+	{
+		m_CompressedClip.getPose(keyFrame, pose);
+	}
+	else
+	{
+		m_Clip.getPose(keyFrame, pose);
+	}
+}
+
+void Animation::getPose(size_t keyFrame, std::span<int const> bones, Transform* pose) const
+{
+	for (int bone : bones)
+	{
+		pose[bone] = getTransform(bone, keyFrame);
+	}
+}
+
+size_t Animation::getMemorySize() const
+{
+	return m_isCompressed ? m_CompressedClip.getMemorySize() : m_Clip.getMemorySize();
 }
@@ -1,17 +1,39 @@
 #pragma once
 
-#include "Transform.h"
-#include "vector"
+#include "AnimationClip.h"
+#include "ClipSampler.h"
+#include "CompressedClip.h"
+
+#include <span>
 
 struct Animation
 {
-	Animation(const char* animName);
+	Animation(const char* animName, AnimationClip&& clip);
+	Animation(const char* animName, CompressedClip&& clip);
+
+	// Turns the clip into an additive one: every key becomes the difference between the key and referencePose, a
+	// local pose indexed like skeleton.m_Bones. Composed over a pose, the key puts back what the clip adds to the
+	// reference.
+	void makeAdditive(Skeleton const& skeleton, std::span<Transform const> referencePose);
+
+	// Same, against the first key of the clip
+	void makeAdditive(Skeleton const& skeleton);
+
+	Transform getTransform(size_t boneIndex, size_t keyFrame) const;
+	void	  getPose(size_t keyFrame, Transform* pose) const;
+
+	// Only writes the transforms of the given bones
+	void getPose(size_t keyFrame, std::span<int const> bones, Transform* pose) const;
 
-	void initTransforms(size_t boneCount);
+	size_t	  getMemorySize() const;
 
-	size_t								m_keyFrameCount = 0;
-	unsigned int						m_keyFrame = 0;
-	float								m_timeAcc = 0.f;
-	const char*							m_Name = nullptr;
-	std::vector<std::vector<Transform>> m_animFrameTransforms;
+	size_t		   m_keyFrameCount = 0;
+	float		   m_duration = 0.f; // Seconds
+	ClipTiming	   m_Timing;
+	ClipPlayback   m_Playback;
+	const char*	   m_Name = nullptr;
+	bool		   m_isCompressed = false;
+	bool		   m_isAdditive = false; // Keys are differences to compose over a pose instead of local transforms
+	AnimationClip  m_Clip;
+	CompressedClip m_CompressedClip;
 };
@@ -0,0 +1,104 @@
+#include "AnimationClip.h"
+
+#include <algorithm>
+#include <new>
+
+AnimationClip::AnimationClip(AnimationFile const& animFile, Skeleton const& skeleton)
+	: m_keyCount(animFile.m_keyCount), m_boneCount(skeleton.m_boneCount), m_duration(animFile.m_duration)
+{
+	allocate();
+
+	for (size_t bone = 0; bone < m_boneCount; bone++)
+	{
+		float* streams[size_t(TrackStream::E_COUNT)];
+		for (size_t stream = 0; stream < size_t(TrackStream::E_COUNT); stream++)
+		{
+			streams[stream] = getOwnedStream(bone, TrackStream(stream));
+		}
+
+		for (size_t key = 0; key < m_keyCount; key++)
+		{
+			AnimationFileKey const& fileKey = animFile.getKey(skeleton.m_Bones[bone].m_sourceIndex, int(key));
+
+			Transform transform(
+				LM_::Vec3(fileKey.m_position[0], fileKey.m_position[1], fileKey.m_position[2]),
+				LM_::Quaternion(fileKey.m_rotation[0], fileKey.m_rotation[1], fileKey.m_rotation[2], fileKey.m_rotation[3]));
+			transform *= skeleton.m_Bones[bone].m_localTransform;
+
+			streams[size_t(TrackStream::E_TRANSLATIONX)][key] = transform.m_Position.m_x;
+			streams[size_t(TrackStream::E_TRANSLATIONY)][key] = transform.m_Position.m_y;
+			streams[size_t(TrackStream::E_TRANSLATIONZ)][key] = transform.m_Position.m_z;
+			streams[size_t(TrackStream::E_ROTATIONW)][key] = transform.m_Rotation.m_a;
+			streams[size_t(TrackStream::E_ROTATIONX)][key] = transform.m_Rotation.m_b;
+			streams[size_t(TrackStream::E_ROTATIONY)][key] = transform.m_Rotation.m_c;
+			streams[size_t(TrackStream::E_ROTATIONZ)][key] = transform.m_Rotation.m_d;
+		}
+	}
+}
+
+AnimationClip::AnimationClip(Transform const* poses, size_t keyCount, size_t boneCount, float duration)
+	: m_keyCount(keyCount), m_boneCount(boneCount), m_duration(duration)
+{
+	allocate();
+
+	for (size_t bone = 0; bone < m_boneCount; bone++)
+	{
+		float* streams[size_t(TrackStream::E_COUNT)];
+		for (size_t stream = 0; stream < size_t(TrackStream::E_COUNT); stream++)
+		{
+			streams[stream] = getOwnedStream(bone, TrackStream(stream));
+		}
+
+		for (size_t key = 0; key < m_keyCount; key++)
+		{
+			Transform const& transform = poses[key * m_boneCount + bone];
+
+			streams[size_t(TrackStream::E_TRANSLATIONX)][key] = transform.m_Position.m_x;
+			streams[size_t(TrackStream::E_TRANSLATIONY)][key] = transform.m_Position.m_y;
+			streams[size_t(TrackStream::E_TRANSLATIONZ)][key] = transform.m_Position.m_z;
+			streams[size_t(TrackStream::E_ROTATIONW)][key] = transform.m_Rotation.m_a;
+			streams[size_t(TrackStream::E_ROTATIONX)][key] = transform.m_Rotation.m_b;
+			streams[size_t(TrackStream::E_ROTATIONY)][key] = transform.m_Rotation.m_c;
+			streams[size_t(TrackStream::E_ROTATIONZ)][key] = transform.m_Rotation.m_d;
+		}
+	}
+}
+
+AnimationClip::AnimationClip(
+	std::shared_ptr<MappedFile> mapping, float const* data, size_t keyCount, size_t keyStride, size_t boneCount, float duration)
+	: m_keyCount(keyCount), m_keyStride(keyStride), m_boneCount(boneCount), m_duration(duration), m_data(data),
+	  m_Mapping(std::move(mapping))
+{
+}
+
+Transform AnimationClip::getTransform(size_t boneIndex, size_t keyFrame) const
+{
+	float const* track = getStream(boneIndex, TrackStream::E_TRANSLATIONX) + keyFrame;
+
+	return Transform(
+		LM_::Vec3(track[0], track[m_keyStride], track[2 * m_keyStride]),
+		LM_::Quaternion(track[3 * m_keyStride], track[4 * m_keyStride], track[5 * m_keyStride], track[6 * m_keyStride]));
+}
+
+void AnimationClip::getPose(size_t keyFrame, Transform* pose) const
+{
+	for (size_t bone = 0; bone < m_boneCount; bone++)
+	{
+		pose[bone] = getTransform(bone, keyFrame);
+	}
+}
+
+void AnimationClip::allocate()
+{
+	m_keyStride = (m_keyCount + STREAM_FLOAT_ALIGNMENT - 1) / STREAM_FLOAT_ALIGNMENT * STREAM_FLOAT_ALIGNMENT;
+
+	size_t floatCount = m_boneCount * size_t(TrackStream::E_COUNT) * m_keyStride;
+	m_OwnedData.reset(static_cast<float*>(::operator new[](floatCount * sizeof(float), std::align_val_t(CLIP_ALIGNMENT))));
+	std::fill_n(m_OwnedData.get(), floatCount, 0.f);
+	m_data = m_OwnedData.get();
+}
+
+void AnimationClip::AlignedDelete::operator()(float* data) const
+{
+	::operator delete[](data, std::align_val_t(CLIP_ALIGNMENT));
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "AnimationFile.h"
+#include "MappedFile.h"
+#include "Skeleton.h"
+#include "Transform.h"
+
+#include <cstddef>
+#include <memory>
+
+enum class TrackStream
+{
+	E_TRANSLATIONX,
+	E_TRANSLATIONY,
+	E_TRANSLATIONZ,
+	E_ROTATIONW,
+	E_ROTATIONX,
+	E_ROTATIONY,
+	E_ROTATIONZ,
+	E_COUNT,
+};
+
+// All the keys of a clip in one aligned block, laid out as structure of arrays per bone track:
+// [bone 0: tx[keys] ty[keys] tz[keys] qw[keys] qx[keys] qy[keys] qz[keys]][bone 1: ...]...
+// Every stream starts on a CLIP_ALIGNMENT boundary so several keys of a stream can be loaded at once.
+// The block is either owned by the clip or used in place from a mapped clip cache file (see ClipCache.h).
+// Keys are local bone transforms, the bind pose is already applied so sampling never has to compose with it.
+class AnimationClip
+{
+  public:
+	static constexpr size_t CLIP_ALIGNMENT = 32;
+	static constexpr size_t STREAM_FLOAT_ALIGNMENT = CLIP_ALIGNMENT / sizeof(float);
+
+	AnimationClip() = default;
+	// Keys of the file composed with the bind pose of skeleton, which the file keys are relative to
+	AnimationClip(AnimationFile const& animFile, Skeleton const& skeleton);
+
+	// Copy of poses given key after key, boneCount transforms per key
+	AnimationClip(Transform const* poses, size_t keyCount, size_t boneCount, float duration);
+
+	// View over a block living in a mapped file, which the clip keeps alive
+	AnimationClip(
+		std::shared_ptr<MappedFile> mapping, float const* data, size_t keyCount, size_t keyStride, size_t boneCount, float duration);
+
+	AnimationClip(AnimationClip&&) = default;
+	AnimationClip& operator=(AnimationClip&&) = default;
+
+	size_t getKeyCount() const
+	{
+		return m_keyCount;
+	}
+
+	size_t getBoneCount() const
+	{
+		return m_boneCount;
+	}
+
+	float getDuration() const
+	{
+		return m_duration;
+	}
+
+	size_t getKeyStride() const
+	{
+		return m_keyStride;
+	}
+
+	bool isMapped() const
+	{
+		return m_Mapping != nullptr;
+	}
+
+	// Keys of one stream of one bone, getKeyCount() of them
+	float const* getStream(size_t boneIndex, TrackStream stream) const
+	{
+		return m_data + (boneIndex * size_t(TrackStream::E_COUNT) + size_t(stream)) * m_keyStride;
+	}
+
+	// The whole block, getMemorySize() bytes
+	float const* getData() const
+	{
+		return m_data;
+	}
+
+	Transform getTransform(size_t boneIndex, size_t keyFrame) const;
+
+	// Writes the transform of every bone at the given key
+	void getPose(size_t keyFrame, Transform* pose) const;
+
+	size_t getMemorySize() const
+	{
+		return m_boneCount * size_t(TrackStream::E_COUNT) * m_keyStride * sizeof(float);
+	}
+
+  private:
+	struct AlignedDelete
+	{
+		void operator()(float* data) const;
+	};
+
+	// Zeroed owned block for the key and bone counts
+	void allocate();
+
+	float* getOwnedStream(size_t boneIndex, TrackStream stream)
+	{
+		return m_OwnedData.get() + (boneIndex * size_t(TrackStream::E_COUNT) + size_t(stream)) * m_keyStride;
+	}
+
+	size_t									m_keyCount = 0;
+	size_t									m_keyStride = 0; // Key count rounded up to STREAM_FLOAT_ALIGNMENT
+	size_t									m_boneCount = 0;
+	float									m_duration = 0.f;
+	float const*							m_data = nullptr;
+	std::unique_ptr<float[], AlignedDelete> m_OwnedData;
+	std::shared_ptr<MappedFile>				m_Mapping;
+};
@@ -0,0 +1,156 @@
+#include "AnimationFile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+static_assert(sizeof(AnimationFileKey) == 10 * sizeof(float), "AnimationFileKey must match the .anim key layout");
+
+namespace
+{
+AnimationFileKey const g_bindKey = { { 0.f, 0.f, 0.f }, { 1.f, 0.f, 0.f, 0.f }, { 1.f, 1.f, 1.f } };
+
+struct TrackView
+{
+	const char* m_keys = nullptr;
+	uint32_t	m_keyCount = 0;
+};
+
+uint32_t readU32(std::vector<char> const& bytes, size_t offset)
+{
+	uint32_t value;
+	memcpy(&value, bytes.data() + offset, sizeof(value));
+	return value;
+}
+} // namespace
+
+AnimationFile::AnimationFile(const char* path)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file)
+	{
+		throw std::runtime_error(std::string("Cannot open animation file ") + path);
+	}
+
+	// Whole file in one read, tracks are then located in place
+	std::vector<char> bytes(size_t(file.tellg()));
+	file.seekg(0);
+	if (!file.read(bytes.data(), bytes.size()) || bytes.size() < 12)
+	{
+		throw std::runtime_error(std::string("Truncated animation header in ") + path);
+	}
+
+	memcpy(&m_duration, bytes.data(), sizeof(m_duration));
+
+	std::vector<TrackView> tracks;
+	tracks.reserve(readU32(bytes, 4));
+
+	for (size_t offset = 12; offset < bytes.size();)
+	{
+		if (offset + 8 > bytes.size())
+		{
+			throw std::runtime_error(std::string("Truncated animation track in ") + path);
+		}
+
+		TrackView& track = tracks.emplace_back();
+		track.m_keyCount = readU32(bytes, offset);
+		track.m_keys = bytes.data() + offset + 8;
+		offset += 8 + size_t(track.m_keyCount) * sizeof(AnimationFileKey);
+
+		if (offset > bytes.size())
+		{
+			throw std::runtime_error(std::string("Truncated animation track in ") + path);
+		}
+
+		m_keyCount = std::max<size_t>(m_keyCount, track.m_keyCount);
+	}
+
+	// Transpose the bone-major tracks into one frame-major buffer
+	m_boneCount = tracks.size();
+	m_Keys.resize(m_keyCount * m_boneCount);
+
+	for (size_t bone = 0; bone < m_boneCount; bone++)
+	{
+		TrackView const& track = tracks[bone];
+		for (size_t frame = 0; frame < m_keyCount; frame++)
+		{
+			AnimationFileKey& key = m_Keys[frame * m_boneCount + bone];
+			if (track.m_keyCount == 0)
+			{
+				key = g_bindKey;
+			}
+			else
+			{
+				size_t source = std::min<size_t>(frame, track.m_keyCount - 1);
+				memcpy(&key, track.m_keys + source * sizeof(AnimationFileKey), sizeof(AnimationFileKey));
+			}
+		}
+	}
+}
+
+AnimationFileKey const& AnimationFile::getKey(int boneIndex, int keyFrameIndex) const
+{
+	if (boneIndex < 0 || boneIndex >= int(m_boneCount) || m_keyCount == 0)
+	{
+		return g_bindKey;
+	}
+
+	return m_Keys[std::min<size_t>(keyFrameIndex, m_keyCount - 1) * m_boneCount + boneIndex];
+}
+
+AnimationFileKey const* AnimationFile::getFrame(int keyFrameIndex) const
+{
+	return &m_Keys[keyFrameIndex * m_boneCount];
+}
+
+std::vector<AnimationFile> loadAnimationFiles(std::vector<std::string> const& paths)
+{
+	std::vector<AnimationFile>		animFiles(paths.size());
+	std::vector<std::exception_ptr> errors(paths.size());
+	std::atomic<size_t>				nextFile = 0;
+
+	auto worker = [&]()
+	{
+		for (size_t index = nextFile++; index < paths.size(); index = nextFile++)
+		{
+			try
+			{
+				animFiles[index] = AnimationFile(paths[index].c_str());
+			}
+			catch (...)
+			{
+				errors[index] = std::current_exception();
+			}
+		}
+	};
+
+	size_t					 threadCount = std::min<size_t>(paths.size(), std::max(1u, std::thread::hardware_concurrency()));
+	std::vector<std::thread> threads;
+	threads.reserve(threadCount);
+
+	for (size_t index = 1; index < threadCount; index++)
+	{
+		threads.emplace_back(worker);
+	}
+	worker();
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	for (std::exception_ptr const& error : errors)
+	{
+		if (error)
+		{
+			std::rethrow_exception(error);
+		}
+	}
+
+	return animFiles;
+}
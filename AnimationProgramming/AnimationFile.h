@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Directory the .anim/.skel files are read from (Data/ is the working directory of the engine)
+#ifndef RESOURCE_DIR
+#define RESOURCE_DIR "Resources/"
+#endif
+
+// Local transform of one bone at one key, relative to its bind pose (rotation is w, x, y, z)
+struct AnimationFileKey
+{
+	float m_position[3];
+	float m_rotation[4];
+	float m_scale[3];
+};
+
+// .anim layout: float duration, u32 boneCount, u32 reserved,
+// then one track per bone until the end of the file: { u32 keyCount, u32 reserved, keyCount * AnimationFileKey }
+struct AnimationFile
+{
+	AnimationFile() = default;
+	AnimationFile(const char* path);
+
+	// Bones without a track (or with an empty one) stay in their bind pose
+	AnimationFileKey const& getKey(int boneIndex, int keyFrameIndex) const;
+
+	// Keys of every bone for one key frame, m_boneCount of them
+	AnimationFileKey const* getFrame(int keyFrameIndex) const;
+
+	float						  m_duration = 0.f;
+	size_t						  m_keyCount = 0;
+	size_t						  m_boneCount = 0;
+	std::vector<AnimationFileKey> m_Keys; // Frame-major: m_Keys[keyFrame * m_boneCount + bone]
+};
+
+// Parses all the given clips in parallel, in the same order as the paths
+std::vector<AnimationFile> loadAnimationFiles(std::vector<std::string> const& paths);
@@ -0,0 +1,53 @@
+#include "AnimationLod.h"
+
+#include <stdexcept>
+
+AnimationLodScheduler::AnimationLodScheduler(std::vector<AnimationLodLevel> levels, float hysteresis)
+	: m_Levels(std::move(levels)), m_hysteresis(hysteresis), m_levelInstanceCounts(m_Levels.size(), 0)
+{
+	if (m_Levels.empty())
+	{
+		throw std::logic_error("AnimationLodScheduler: no level of detail");
+	}
+	for (size_t level = 1; level < m_Levels.size(); level++)
+	{
+		if (m_Levels[level].m_minImportance > m_Levels[level - 1].m_minImportance)
+		{
+			throw std::logic_error("AnimationLodScheduler: levels must go by decreasing importance");
+		}
+	}
+}
+
+void AnimationLodScheduler::schedule(std::span<float const> importances, CharacterInstances& instances)
+{
+	if (importances.size() != instances.getInstanceCount())
+	{
+		throw std::logic_error("AnimationLodScheduler::schedule: one importance per instance expected");
+	}
+
+	m_instanceLevels.resize(importances.size(), -1);
+	m_levelInstanceCounts.assign(m_Levels.size(), 0);
+	int lastLevel = int(m_Levels.size()) - 1;
+	for (size_t instance = 0; instance < importances.size(); instance++)
+	{
+		float importance = importances[instance];
+		int	  level = 0;
+		while (level < lastLevel && importance < m_Levels[level].m_minImportance)
+		{
+			level++;
+		}
+
+		int current = m_instanceLevels[instance];
+		if (current != -1 && level > current && importance >= m_Levels[current].m_minImportance - m_hysteresis)
+		{
+			level = current;
+		}
+
+		if (level != current)
+		{
+			m_instanceLevels[instance] = level;
+			instances.setLod(instance, m_Levels[level].m_skeletonLod, m_Levels[level].m_updateInterval);
+		}
+		m_levelInstanceCounts[level]++;
+	}
+}
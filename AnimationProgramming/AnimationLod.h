@@ -0,0 +1,48 @@
+#pragma once
+
+#include "CharacterInstances.h"
+
+#include <span>
+#include <vector>
+
+// Level of detail used by the instances whose importance is at least m_minImportance
+struct AnimationLodLevel
+{
+	float m_minImportance = 0.f;
+	int	  m_skeletonLod = 0;	// Index in Skeleton::m_Lods
+	int	  m_updateInterval = 1; // Frames between two evaluations
+};
+
+// Picks the level of detail of every instance of a crowd from an importance given by the caller each frame (screen
+// size, distance to the camera, gameplay relevance...), so the cost of the crowd follows what is seen of it
+class AnimationLodScheduler
+{
+  public:
+	// levels go from the most detailed to the least, by decreasing m_minImportance; the last one gets every importance
+	// below the others. An instance only moves to a less detailed level once its importance is hysteresis below the
+	// threshold of its current one, so importances close to a threshold do not switch every frame.
+	// Throws std::logic_error if levels is empty or not sorted.
+	AnimationLodScheduler(std::vector<AnimationLodLevel> levels, float hysteresis = 0.f);
+
+	// importances holds one value per instance of instances, throws std::logic_error otherwise
+	void schedule(std::span<float const> importances, CharacterInstances& instances);
+
+	// Index in the levels of an instance after the last schedule()
+	int getLevel(size_t instance) const
+	{
+		return m_instanceLevels[instance];
+	}
+
+	// Instances at each level after the last schedule()
+	std::vector<size_t> const& getLevelInstanceCounts() const
+	{
+		return m_levelInstanceCounts;
+	}
+
+  private:
+	std::vector<AnimationLodLevel> m_Levels;
+	float						   m_hysteresis = 0.f;
+
+	std::vector<int>	m_instanceLevels; // -1 until an instance is scheduled
+	std::vector<size_t> m_levelInstanceCounts;
+};
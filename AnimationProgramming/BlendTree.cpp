@@ -0,0 +1,481 @@
+#include "BlendTree.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+BlendTree::BlendTree(Skeleton const& skeleton, std::vector<Animation> const& animations)
+	: m_Skeleton(skeleton), m_Animations(animations), m_allBones(skeleton.m_boneCount)
+{
+	std::iota(m_allBones.begin(), m_allBones.end(), 0);
+}
+
+int BlendTree::addParameter(float value)
+{
+	m_parameters.push_back(value);
+	return int(m_parameters.size()) - 1;
+}
+
+void BlendTree::setParameter(int parameter, float value)
+{
+	m_parameters[parameter] = value;
+}
+
+float BlendTree::getParameter(int parameter) const
+{
+	return m_parameters[parameter];
+}
+
+int BlendTree::addSyncGroup()
+{
+	m_SyncGroups.emplace_back();
+	return int(m_SyncGroups.size()) - 1;
+}
+
+int BlendTree::addClip(int clipIndex, float speed, int syncGroup)
+{
+	if (clipIndex < 0 || clipIndex >= int(m_Animations.size()))
+	{
+		throw std::logic_error("Blend tree clip index out of range");
+	}
+	if (syncGroup < -1 || syncGroup >= int(m_SyncGroups.size()))
+	{
+		throw std::logic_error("Blend tree sync group out of range");
+	}
+
+	Node node;
+	node.m_type = BlendNodeType::E_CLIP;
+	node.m_clipIndex = clipIndex;
+	node.m_syncGroup = syncGroup;
+	node.m_Playback.m_speed = speed;
+	node.m_KeyPairs = KeyPairCache(m_Skeleton.m_boneCount);
+
+	int index = addNode(std::move(node));
+	if (syncGroup != -1)
+	{
+		m_SyncGroups[syncGroup].m_Clips.push_back(index);
+	}
+	return index;
+}
+
+int BlendTree::addBlendSpace1D(int parameter, std::vector<int> const& children, std::vector<float> const& thresholds)
+{
+	if (children.empty() || thresholds.size() != children.size() || !std::is_sorted(thresholds.begin(), thresholds.end()))
+	{
+		throw std::logic_error("Blend space needs one increasing threshold per child");
+	}
+
+	Node node;
+	node.m_type = BlendNodeType::E_BLEND_SPACE_1D;
+	node.m_parameter = parameter;
+	node.m_Children = children;
+	node.m_thresholds = thresholds;
+	return addNode(std::move(node));
+}
+
+int BlendTree::addBoneMask(BoneMask const& mask)
+{
+	if (mask.m_weights.size() != m_Skeleton.m_boneCount)
+	{
+		throw std::logic_error("Bone mask made for another skeleton");
+	}
+
+	m_BoneMasks.push_back(mask);
+	return int(m_BoneMasks.size()) - 1;
+}
+
+int BlendTree::addAdditive(int base, int additive, int weightParameter, int mask)
+{
+	Node node;
+	node.m_type = BlendNodeType::E_ADDITIVE;
+	node.m_parameter = weightParameter;
+	node.m_mask = mask;
+	node.m_Children = { base, additive };
+	return addNode(std::move(node));
+}
+
+int BlendTree::addLayer(int base, int overlay, int weightParameter, int mask)
+{
+	Node node;
+	node.m_type = BlendNodeType::E_LAYER;
+	node.m_parameter = weightParameter;
+	node.m_mask = mask;
+	node.m_Children = { base, overlay };
+	return addNode(std::move(node));
+}
+
+int BlendTree::addBlend(std::vector<int> const& children, std::vector<int> const& weightParameters)
+{
+	if (children.empty() || weightParameters.size() != children.size())
+	{
+		throw std::logic_error("Blend needs one weight parameter per child");
+	}
+
+	Node node;
+	node.m_type = BlendNodeType::E_BLEND;
+	node.m_Children = children;
+	node.m_weightParameters = weightParameters;
+	return addNode(std::move(node));
+}
+
+int BlendTree::addNode(Node&& node)
+{
+	for (int child : node.m_Children)
+	{
+		if (child < 0 || child >= int(m_Nodes.size()))
+		{
+			throw std::logic_error("Blend tree children must be added before their parent");
+		}
+	}
+
+	auto isValidParameter = [this](int parameter) { return parameter >= 0 && parameter < int(m_parameters.size()); };
+	if (node.m_type != BlendNodeType::E_CLIP && node.m_type != BlendNodeType::E_BLEND && !isValidParameter(node.m_parameter))
+	{
+		throw std::logic_error("Blend tree parameter index out of range");
+	}
+	if (!std::all_of(node.m_weightParameters.begin(), node.m_weightParameters.end(), isValidParameter))
+	{
+		throw std::logic_error("Blend tree parameter index out of range");
+	}
+
+	if (node.m_mask < -1 || node.m_mask >= int(m_BoneMasks.size()))
+	{
+		throw std::logic_error("Blend tree bone mask out of range");
+	}
+
+	// A clip node is sampled once per path leading to it at most, for as many cached samples
+	node.m_clipPaths = node.m_type == BlendNodeType::E_CLIP ? 1 : 0;
+	for (int child : node.m_Children)
+	{
+		node.m_clipPaths += m_Nodes[child].m_clipPaths;
+	}
+	m_ClipCache.reserve(node.m_clipPaths);
+
+	node.m_childWeights.assign(node.m_Children.size(), 0.f);
+	m_Nodes.push_back(std::move(node));
+	m_nodeWeights.push_back(0.f);
+	return int(m_Nodes.size()) - 1;
+}
+
+void BlendTree::evaluate(float frameTime, FrameArena& arena, std::span<Transform> localPose)
+{
+	evaluate(int(m_Nodes.size()) - 1, frameTime, arena, localPose);
+}
+
+void BlendTree::evaluate(int root, float frameTime, FrameArena& arena, std::span<Transform> localPose)
+{
+	if (m_Nodes.empty())
+	{
+		for (size_t bone = 0; bone < m_Skeleton.m_boneCount; bone++)
+		{
+			localPose[bone] = m_Skeleton.m_Bones[bone].m_localTransform;
+		}
+		return;
+	}
+	if (root < 0 || root >= int(m_Nodes.size()))
+	{
+		throw std::logic_error("Blend tree root out of range");
+	}
+
+	updateWeights(root);
+
+	for (SyncGroup& group : m_SyncGroups)
+	{
+		updateSyncGroup(group, frameTime);
+	}
+
+	for (size_t index = 0; index < m_Nodes.size(); index++)
+	{
+		Node& node = m_Nodes[index];
+		if (node.m_type == BlendNodeType::E_CLIP && node.m_syncGroup == -1 && m_nodeWeights[index] > 0.f)
+		{
+			node.m_Playback.advance(m_Animations[node.m_clipIndex].m_Timing, frameTime);
+		}
+	}
+
+	m_ClipCache.clear();
+	evaluateNode(root, arena, localPose, m_allBones);
+}
+
+size_t BlendTree::getActiveNodeCount() const
+{
+	return std::count_if(m_nodeWeights.begin(), m_nodeWeights.end(), [](float weight) { return weight > 0.f; });
+}
+
+void BlendTree::updateWeights(int root)
+{
+	std::fill(m_nodeWeights.begin(), m_nodeWeights.end(), 0.f);
+	m_nodeWeights[root] = 1.f;
+
+	for (int index = root; index >= 0; index--)
+	{
+		Node& node = m_Nodes[index];
+		if (m_nodeWeights[index] <= 0.f || node.m_Children.empty())
+		{
+			continue;
+		}
+
+		std::vector<float>& weights = node.m_childWeights;
+		std::fill(weights.begin(), weights.end(), 0.f);
+
+		switch (node.m_type)
+		{
+		case BlendNodeType::E_BLEND_SPACE_1D:
+		{
+			std::vector<float> const& thresholds = node.m_thresholds;
+			float					  position = m_parameters[node.m_parameter];
+
+			size_t upper = std::upper_bound(thresholds.begin(), thresholds.end(), position) - thresholds.begin();
+			if (upper == 0)
+			{
+				weights.front() = 1.f;
+			}
+			else if (upper == thresholds.size())
+			{
+				weights.back() = 1.f;
+			}
+			else
+			{
+				float alpha = (position - thresholds[upper - 1]) / (thresholds[upper] - thresholds[upper - 1]);
+				weights[upper - 1] = 1.f - alpha;
+				weights[upper] = alpha;
+			}
+			break;
+		}
+		case BlendNodeType::E_ADDITIVE:
+		case BlendNodeType::E_LAYER:
+			weights[0] = 1.f;
+			weights[1] = std::clamp(m_parameters[node.m_parameter], 0.f, 1.f);
+			break;
+		case BlendNodeType::E_BLEND:
+		{
+			float total = 0.f;
+			for (size_t child = 0; child < weights.size(); child++)
+			{
+				weights[child] = std::max(0.f, m_parameters[node.m_weightParameters[child]]);
+				total += weights[child];
+			}
+
+			if (total > 0.f)
+			{
+				for (float& weight : weights)
+				{
+					weight /= total;
+				}
+			}
+			else
+			{
+				weights.front() = 1.f;
+			}
+			break;
+		}
+		default:
+			break;
+		}
+
+		for (size_t child = 0; child < weights.size(); child++)
+		{
+			m_nodeWeights[node.m_Children[child]] += m_nodeWeights[index] * weights[child];
+		}
+	}
+}
+
+void BlendTree::updateSyncGroup(SyncGroup& group, float frameTime)
+{
+	// Phase rate of each active clip weighted by its share of the group, a group without active clips stays paused
+	double rate = 0.0;
+	double totalWeight = 0.0;
+	for (int index : group.m_Clips)
+	{
+		Node const& node = m_Nodes[index];
+		float		weight = m_nodeWeights[index];
+		if (weight > 0.f)
+		{
+			rate += weight * node.m_Playback.m_speed * m_Animations[node.m_clipIndex].m_Timing.getPhaseRate(group.m_phase);
+			totalWeight += weight;
+		}
+	}
+
+	if (totalWeight == 0.0)
+	{
+		return;
+	}
+
+	group.m_phase += frameTime * rate / totalWeight;
+	group.m_phase -= std::floor(group.m_phase);
+
+	// Inactive clips follow as well so they come in at the right phase
+	for (int index : group.m_Clips)
+	{
+		Node& node = m_Nodes[index];
+		node.m_Playback.m_time = m_Animations[node.m_clipIndex].m_Timing.phaseToTime(group.m_phase);
+	}
+}
+
+void BlendTree::evaluateNode(int index, FrameArena& arena, std::span<Transform> localPose, std::span<int const> bones)
+{
+	Node const& node = m_Nodes[index];
+	size_t		boneCount = m_Skeleton.m_boneCount;
+
+	switch (node.m_type)
+	{
+	case BlendNodeType::E_CLIP:
+		sampleClip(m_Nodes[index], arena, localPose, bones);
+		break;
+	case BlendNodeType::E_ADDITIVE:
+	case BlendNodeType::E_LAYER:
+	{
+		evaluateNode(node.m_Children[0], arena, localPose, bones);
+
+		float					  weight = node.m_childWeights[1];
+		std::span<int const>	  layerBones = getMaskedBones(node.m_mask, bones, arena);
+		std::vector<float> const* maskWeights = node.m_mask != -1 ? &m_BoneMasks[node.m_mask].m_weights : nullptr;
+		if (weight <= 0.f || layerBones.empty())
+		{
+			break;
+		}
+
+		std::span<Transform> layerPose = arena.allocate<Transform>(boneCount);
+		evaluateNode(node.m_Children[1], arena, layerPose, layerBones);
+
+		if (node.m_type == BlendNodeType::E_LAYER)
+		{
+			for (int bone : layerBones)
+			{
+				float boneWeight = maskWeights ? weight * (*maskWeights)[bone] : weight;
+				localPose[bone] = interpolate(localPose[bone], layerPose[bone], boneWeight);
+			}
+			break;
+		}
+
+		if (weight < 1.f || maskWeights)
+		{
+			Transform identity(LM_::Vec3::zero(), LM_::Quaternion(1.f, 0.f, 0.f, 0.f));
+			for (int bone : layerBones)
+			{
+				float boneWeight = maskWeights ? weight * (*maskWeights)[bone] : weight;
+				if (boneWeight < 1.f)
+				{
+					layerPose[bone] = interpolate(identity, layerPose[bone], boneWeight);
+				}
+			}
+		}
+
+		// Differences apply in the bone space of the base, the way clip keys apply over the bind pose
+		if (isFullPose(layerBones))
+		{
+			LM_::compose(getRigidTransforms(layerPose.data()), getRigidTransforms(localPose.data()),
+						 getRigidTransforms(localPose.data()), boneCount);
+		}
+		else
+		{
+			for (int bone : layerBones)
+			{
+				localPose[bone] = layerPose[bone] * localPose[bone];
+			}
+		}
+		break;
+	}
+	default:
+	{
+		// Running blend of the active children: each one is mixed in with its share of the weight seen so far
+		std::span<Transform> childPose;
+		float				 totalWeight = 0.f;
+		for (size_t child = 0; child < node.m_Children.size(); child++)
+		{
+			float weight = node.m_childWeights[child];
+			if (weight <= 0.f)
+			{
+				continue;
+			}
+
+			if (totalWeight == 0.f)
+			{
+				evaluateNode(node.m_Children[child], arena, localPose, bones);
+				totalWeight = weight;
+				continue;
+			}
+
+			if (childPose.empty())
+			{
+				childPose = arena.allocate<Transform>(boneCount);
+			}
+			evaluateNode(node.m_Children[child], arena, childPose, bones);
+
+			totalWeight += weight;
+			float alpha = weight / totalWeight;
+			for (int bone : bones)
+			{
+				localPose[bone] = interpolate(localPose[bone], childPose[bone], alpha);
+			}
+		}
+		break;
+	}
+	}
+}
+
+void BlendTree::sampleClip(Node& node, FrameArena& arena, std::span<Transform> localPose, std::span<int const> bones)
+{
+	size_t boneCount = m_Skeleton.m_boneCount;
+	double time = node.m_Playback.m_time;
+	bool   isFull = isFullPose(bones);
+
+	// A full sample serves any set of bones, a partial one only the same set
+	for (CachedClip const& cached : m_ClipCache)
+	{
+		if (cached.m_clipIndex == node.m_clipIndex && cached.m_time == time &&
+			(isFullPose(cached.m_bones) || cached.m_bones.data() == bones.data()))
+		{
+			for (int bone : bones)
+			{
+				localPose[bone] = cached.m_pose[bone];
+			}
+			return;
+		}
+	}
+
+	Animation const& animation = m_Animations[node.m_clipIndex];
+	if (isFull)
+	{
+		std::span<Transform const> pose = node.m_KeyPairs.sample(animation, time);
+		std::copy(pose.begin(), pose.end(), localPose.begin());
+		m_ClipCache.push_back({ node.m_clipIndex, time, bones, pose.data() });
+		return;
+	}
+
+	ClipSample			 sample = animation.m_Timing.sample(time);
+	std::span<Transform> nextPose = arena.allocate<Transform>(boneCount);
+	animation.getPose(sample.m_key, bones, localPose.data());
+	animation.getPose(sample.m_nextKey, bones, nextPose.data());
+
+	for (int bone : bones)
+	{
+		localPose[bone] = interpolate(localPose[bone], nextPose[bone], sample.m_alpha);
+	}
+
+	// The next pose is not needed anymore, it keeps the sample for the other nodes of this clip
+	for (int bone : bones)
+	{
+		nextPose[bone] = localPose[bone];
+	}
+	m_ClipCache.push_back({ node.m_clipIndex, time, bones, nextPose.data() });
+}
+
+std::span<int const> BlendTree::getMaskedBones(int mask, std::span<int const> bones, FrameArena& arena) const
+{
+	if (mask == -1)
+	{
+		return bones;
+	}
+
+	std::vector<int> const& maskBones = m_BoneMasks[mask].m_bones;
+	if (isFullPose(bones))
+	{
+		return maskBones;
+	}
+
+	std::span<int> common = arena.allocate<int>(std::min(bones.size(), maskBones.size()));
+	auto		   end = std::set_intersection(bones.begin(), bones.end(), maskBones.begin(), maskBones.end(), common.begin());
+	return common.first(end - common.begin());
+}
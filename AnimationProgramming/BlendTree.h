@@ -0,0 +1,131 @@
+#pragma once
+
+#include "Animation.h"
+#include "BoneMask.h"
+#include "FrameArena.h"
+#include "KeyPairCache.h"
+#include "Skeleton.h"
+#include "Transform.h"
+
+#include <span>
+#include <vector>
+
+enum class BlendNodeType
+{
+	E_CLIP,
+	E_BLEND_SPACE_1D,
+	E_ADDITIVE,
+	E_BLEND,
+	E_LAYER,
+};
+
+// Animation graph producing the local pose of one character.
+// Nodes are added children first and the last node added is the root. Every evaluate() works out the weight of each
+// node from the root down, then only samples and blends the nodes whose weight is not zero: the cost follows the
+// active part of the graph, not its size. Clip nodes sampling the same clip at the same time share one sample.
+// Additive and layer nodes can be limited to a BoneMask: their second child is only evaluated on the bones of the mask,
+// down to the clips which only sample those bones, so an upper body overlay costs the upper body alone.
+// Clips of a sync group play at one shared phase (see ClipTiming), moving at the weighted rate of its active clips,
+// so a blend of walk and run cycles keeps its feet in step whatever the weights.
+class BlendTree
+{
+  public:
+	BlendTree(Skeleton const& skeleton, std::vector<Animation> const& animations);
+
+	// Returns the index of the new parameter
+	int	  addParameter(float value = 0.f);
+	void  setParameter(int parameter, float value);
+	float getParameter(int parameter) const;
+
+	// Returns the index of the new sync group
+	int addSyncGroup();
+
+	// The add functions return the index of the new node, children must be added before their parents
+
+	// Plays a clip, negative speeds play it backward. Without a sync group the clip keeps its own playhead.
+	int addClip(int clipIndex, float speed = 1.f, int syncGroup = -1);
+
+	// Blends the two children around the value of parameter, thresholds are increasing and one per child
+	int addBlendSpace1D(int parameter, std::vector<int> const& children, std::vector<float> const& thresholds);
+
+	// Returns the index of the new mask, made for the skeleton of the tree
+	int addBoneMask(BoneMask const& mask);
+
+	// Composes over base the differences played by additive (additive clips, see Animation::makeAdditive), scaled by
+	// weightParameter in [0, 1] and the weight of each bone in mask, -1 for every bone
+	int addAdditive(int base, int additive, int weightParameter, int mask = -1);
+
+	// Blends overlay over base by weightParameter in [0, 1] times the weight of each bone in mask, -1 for every bone
+	int addLayer(int base, int overlay, int weightParameter, int mask = -1);
+
+	// Weighted average of the children, weights are read from the parameters and normalized
+	int addBlend(std::vector<int> const& children, std::vector<int> const& weightParameters);
+
+	// Advances the clips of the active nodes by frameTime and writes the local pose of the root.
+	// Temporary poses come from arena, nothing else is allocated.
+	void evaluate(float frameTime, FrameArena& arena, std::span<Transform> localPose);
+
+	// Same as evaluate() with the given node as the root, only that node and the nodes below it play
+	void evaluate(int root, float frameTime, FrameArena& arena, std::span<Transform> localPose);
+
+	// Nodes that contributed to the last evaluate()
+	size_t getActiveNodeCount() const;
+
+  private:
+	struct Node
+	{
+		BlendNodeType	   m_type = BlendNodeType::E_CLIP;
+		int				   m_clipIndex = -1; // E_CLIP
+		int				   m_syncGroup = -1; // E_CLIP
+		int				   m_parameter = -1; // E_BLEND_SPACE_1D: blend position, E_ADDITIVE and E_LAYER: weight
+		int				   m_mask = -1;		 // E_ADDITIVE and E_LAYER
+		std::vector<int>   m_Children;
+		std::vector<float> m_thresholds;	   // E_BLEND_SPACE_1D
+		std::vector<int>   m_weightParameters; // E_BLEND
+		std::vector<float> m_childWeights;	   // Share of each child in this node, updated by every evaluate()
+		ClipPlayback	   m_Playback;		   // E_CLIP
+		KeyPairCache	   m_KeyPairs;		   // E_CLIP, full poses only
+		size_t			   m_clipPaths = 0;	   // Paths from this node down to a clip node, itself included
+	};
+
+	struct SyncGroup
+	{
+		std::vector<int> m_Clips; // Clip nodes of the group
+		double			 m_phase = 0.0;
+	};
+
+	struct CachedClip
+	{
+		int					 m_clipIndex = -1;
+		double				 m_time = 0.0;
+		std::span<int const> m_bones; // Bones of m_pose that were sampled
+		Transform const*	 m_pose = nullptr;
+	};
+
+	int	 addNode(Node&& node);
+	void updateWeights(int root);
+	void updateSyncGroup(SyncGroup& group, float frameTime);
+
+	// Poses are indexed like m_Skeleton.m_Bones and only the listed bones are written
+	void evaluateNode(int index, FrameArena& arena, std::span<Transform> localPose, std::span<int const> bones);
+	void sampleClip(Node& node, FrameArena& arena, std::span<Transform> localPose, std::span<int const> bones);
+
+	// bones restricted to the bones of mask, -1 keeps them all
+	std::span<int const> getMaskedBones(int mask, std::span<int const> bones, FrameArena& arena) const;
+
+	bool isFullPose(std::span<int const> bones) const
+	{
+		return bones.size() == m_Skeleton.m_boneCount;
+	}
+
+	Skeleton const&				  m_Skeleton;
+	std::vector<Animation> const& m_Animations;
+	std::vector<int>			  m_allBones; // 0 to m_Skeleton.m_boneCount - 1
+
+	std::vector<float>		m_parameters;
+	std::vector<Node>		m_Nodes;
+	std::vector<SyncGroup>	m_SyncGroups;
+	std::vector<BoneMask>	m_BoneMasks;
+	std::vector<float>		m_nodeWeights; // Weight of each node in the root pose
+	std::vector<CachedClip> m_ClipCache;   // Clips sampled by the current evaluate(), reserved for every path to a clip
+};
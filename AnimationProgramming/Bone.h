@@ -5,9 +5,10 @@
 
 struct Bone
 {
-	Bone(int boneIndex, int parentIndexModifier);
+	Bone(int boneIndex);
 
-	int			m_parentIndex = 0;
+	int			m_parentIndex = 0; // -1 for roots
+	int			m_sourceIndex = 0; // Index in the engine skeleton, which the .anim tracks and .msh bone indices follow
 	const char* m_Name = nullptr;
 	Transform	m_localTransform;
-};
\ No newline at end of file
+};
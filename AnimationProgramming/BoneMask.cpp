@@ -0,0 +1,38 @@
+#include "BoneMask.h"
+
+#include <stdexcept>
+#include <string>
+
+BoneMask::BoneMask(Skeleton const& skeleton, const char* rootBoneName, float weight) : m_weights(skeleton.m_boneCount, 0.f)
+{
+	setWeight(skeleton, rootBoneName, weight);
+}
+
+void BoneMask::setWeight(Skeleton const& skeleton, const char* boneName, float weight)
+{
+	int root = skeleton.findBone(boneName);
+	if (root == -1)
+	{
+		throw std::logic_error(std::string("No bone named ") + boneName);
+	}
+
+	m_weights.resize(skeleton.m_boneCount, 0.f);
+	m_bones.clear();
+	for (int index = 0; index < int(skeleton.m_boneCount); index++)
+	{
+		int ancestor = index;
+		while (ancestor != -1 && ancestor != root)
+		{
+			ancestor = skeleton.m_Bones[ancestor].m_parentIndex;
+		}
+
+		if (ancestor == root)
+		{
+			m_weights[index] = weight;
+		}
+		if (m_weights[index] != 0.f)
+		{
+			m_bones.push_back(index);
+		}
+	}
+}
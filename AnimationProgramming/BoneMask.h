@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Skeleton.h"
+
+#include <vector>
+
+// Weight of each bone of a Skeleton in a layer, with the list of the bones that have one so evaluating the layer
+// can go over those alone
+struct BoneMask
+{
+	BoneMask() = default;
+
+	// rootBoneName and every bone below it weigh weight, the other bones 0.
+	// Throws std::logic_error if the skeleton has no bone of that name.
+	BoneMask(Skeleton const& skeleton, const char* rootBoneName, float weight = 1.f);
+
+	// Sets the weight of boneName and every bone below it, 0 removes them from the mask
+	void setWeight(Skeleton const& skeleton, const char* boneName, float weight);
+
+	std::vector<float> m_weights; // Indexed like Skeleton::m_Bones
+	std::vector<int>   m_bones;	  // Bones whose weight is not 0, in increasing order
+};
@@ -0,0 +1,260 @@
+#include "CharacterInstances.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+CharacterInstances::CharacterInstances(Skeleton const& skeleton, std::vector<Animation> const& animations)
+	: m_Skeleton(skeleton), m_Animations(animations)
+{
+}
+
+size_t CharacterInstances::addInstance(int clipIndex, double startTime)
+{
+	m_clipIndices.push_back(clipIndex);
+	m_clipTimes.push_back(m_Animations[clipIndex].m_Timing.wrapTime(startTime));
+	m_playbackSpeeds.push_back(1.f);
+	m_blendClipIndices.push_back(clipIndex);
+	m_blendWeights.push_back(0.f);
+	m_skeletonLods.push_back(0);
+	m_updateIntervals.push_back(1);
+	m_lastEvaluationTimes.push_back(-1.0);
+	m_previousEvaluationTimes.push_back(-1.0);
+	m_isDue.push_back(1);
+	m_hasNewPose.push_back(1);
+
+	// Bones left out by a level of detail keep their bind transform
+	for (Bone const& bone : m_Skeleton.m_Bones)
+	{
+		m_LocalPoses.push_back(bone.m_localTransform);
+	}
+
+	size_t poseSize = m_clipIndices.size() * m_Skeleton.m_boneCount;
+	m_ModelPoses.resize(poseSize);
+	m_SkinningMatrices.resize(poseSize);
+	m_LastModelPoses.resize(poseSize);
+	m_PreviousModelPoses.resize(poseSize);
+
+	return m_clipIndices.size() - 1;
+}
+
+void CharacterInstances::setPlaybackSpeed(size_t instance, float speed)
+{
+	m_playbackSpeeds[instance] = speed;
+}
+
+void CharacterInstances::setBlend(size_t instance, int blendClipIndex, float blendWeight)
+{
+	m_blendClipIndices[instance] = blendClipIndex;
+	m_blendWeights[instance] = blendWeight;
+}
+
+void CharacterInstances::setLod(size_t instance, int skeletonLod, int updateInterval)
+{
+	if (instance >= m_clipIndices.size() || skeletonLod < 0 || skeletonLod >= int(m_Skeleton.m_Lods.size()))
+	{
+		throw std::logic_error("CharacterInstances::setLod: instance or skeleton level of detail out of range");
+	}
+	if (updateInterval < 1)
+	{
+		throw std::logic_error("CharacterInstances::setLod: the update interval must be at least 1");
+	}
+
+	if (m_skeletonLods[instance] != skeletonLod || m_updateIntervals[instance] != updateInterval)
+	{
+		m_skeletonLods[instance] = skeletonLod;
+		m_updateIntervals[instance] = updateInterval;
+		m_lastEvaluationTimes[instance] = -1.0;
+		m_previousEvaluationTimes[instance] = -1.0;
+
+		// Bones a finer level sampled go back to bind, the forced evaluation samples the others again
+		Transform* localPose = m_LocalPoses.data() + instance * m_Skeleton.m_boneCount;
+		for (size_t bone = 0; bone < m_Skeleton.m_boneCount; bone++)
+		{
+			localPose[bone] = m_Skeleton.m_Bones[bone].m_localTransform;
+		}
+	}
+}
+
+void CharacterInstances::update(float frameTime)
+{
+	m_time += frameTime;
+	for (size_t instance = 0; instance < m_clipIndices.size(); instance++)
+	{
+		ClipTiming const& timing = m_Animations[m_clipIndices[instance]].m_Timing;
+		m_clipTimes[instance] = timing.wrapTime(m_clipTimes[instance] + double(frameTime) * m_playbackSpeeds[instance]);
+	}
+}
+
+void CharacterInstances::evaluate(JobSystem& jobSystem)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	if (m_Scratches.size() != jobSystem.getWorkerCount())
+	{
+		size_t boneCount = m_Skeleton.m_boneCount;
+		m_Scratches.assign(
+			jobSystem.getWorkerCount(), WorkerScratch{ std::vector<Transform>(boneCount), std::vector<Transform>(boneCount),
+													   std::vector<Transform>(boneCount) });
+	}
+
+	// Instances whose turn it is, the first ones of an interval are spread over its frames
+	size_t instanceCount = m_clipIndices.size();
+	m_evaluatedInstanceCount = 0;
+	m_evaluatedBoneCount = 0;
+	for (size_t instance = 0; instance < instanceCount; instance++)
+	{
+		size_t interval = m_updateIntervals[instance];
+		m_isDue[instance] = m_lastEvaluationTimes[instance] < 0.0 || (m_frameIndex + instance) % interval == 0;
+		if (m_isDue[instance])
+		{
+			m_evaluatedInstanceCount++;
+			m_evaluatedBoneCount += m_Skeleton.m_Lods[m_skeletonLods[instance]].m_Bones.size();
+		}
+	}
+	m_frameIndex++;
+
+	jobSystem.parallelFor(
+		instanceCount, INSTANCES_PER_JOB,
+		[&](size_t begin, size_t end) { sampleInstances(begin, end, m_Scratches[jobSystem.getWorkerIndex()]); });
+	jobSystem.parallelFor(
+		instanceCount, INSTANCES_PER_JOB,
+		[&](size_t begin, size_t end) { blendInstances(begin, end, m_Scratches[jobSystem.getWorkerIndex()]); });
+	jobSystem.parallelFor(
+		instanceCount, INSTANCES_PER_JOB, [&](size_t begin, size_t end) { localToModelInstances(begin, end); });
+	jobSystem.parallelFor(instanceCount, INSTANCES_PER_JOB, [&](size_t begin, size_t end) { skinInstances(begin, end); });
+
+	m_evaluateMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+double CharacterInstances::getCharactersPerMillisecond() const
+{
+	return m_evaluateMilliseconds > 0.0 ? m_clipIndices.size() / m_evaluateMilliseconds : 0.0;
+}
+
+void CharacterInstances::samplePose(
+	WorkerScratch& scratch, int clipIndex, double clipTime, std::span<int const> bones, Transform* pose) const
+{
+	Animation const& animation = m_Animations[clipIndex];
+	ClipSample		 sample = animation.m_Timing.sample(clipTime);
+	if (bones.size() == m_Skeleton.m_boneCount)
+	{
+		animation.getPose(sample.m_key, scratch.m_KeyPose.data());
+		animation.getPose(sample.m_nextKey, scratch.m_NextKeyPose.data());
+	}
+	else
+	{
+		animation.getPose(sample.m_key, bones, scratch.m_KeyPose.data());
+		animation.getPose(sample.m_nextKey, bones, scratch.m_NextKeyPose.data());
+	}
+
+	for (int bone : bones)
+	{
+		pose[bone] = interpolate(scratch.m_KeyPose[bone], scratch.m_NextKeyPose[bone], sample.m_alpha);
+	}
+}
+
+void CharacterInstances::sampleInstances(size_t begin, size_t end, WorkerScratch& scratch)
+{
+	for (size_t instance = begin; instance < end; instance++)
+	{
+		if (!m_isDue[instance])
+		{
+			continue;
+		}
+
+		Transform* localPose = m_LocalPoses.data() + instance * m_Skeleton.m_boneCount;
+		samplePose(scratch, m_clipIndices[instance], m_clipTimes[instance],
+				   m_Skeleton.m_Lods[m_skeletonLods[instance]].m_Bones, localPose);
+	}
+}
+
+void CharacterInstances::blendInstances(size_t begin, size_t end, WorkerScratch& scratch)
+{
+	for (size_t instance = begin; instance < end; instance++)
+	{
+		float blendWeight = m_blendWeights[instance];
+		if (blendWeight <= 0.f || !m_isDue[instance])
+		{
+			continue;
+		}
+
+		// Same phase in the blend clip
+		int				  blendClipIndex = m_blendClipIndices[instance];
+		ClipTiming const& timing = m_Animations[m_clipIndices[instance]].m_Timing;
+		ClipPlayback	  blendPlayback;
+		blendPlayback.syncTo(m_Animations[blendClipIndex].m_Timing, timing, m_clipTimes[instance]);
+
+		std::vector<int> const& bones = m_Skeleton.m_Lods[m_skeletonLods[instance]].m_Bones;
+		samplePose(scratch, blendClipIndex, blendPlayback.m_time, bones, scratch.m_BlendPose.data());
+
+		Transform* localPose = m_LocalPoses.data() + instance * m_Skeleton.m_boneCount;
+		for (int bone : bones)
+		{
+			localPose[bone] = interpolate(localPose[bone], scratch.m_BlendPose[bone], blendWeight);
+		}
+	}
+}
+
+void CharacterInstances::localToModelInstances(size_t begin, size_t end)
+{
+	size_t boneCount = m_Skeleton.m_boneCount;
+	for (size_t instance = begin; instance < end; instance++)
+	{
+		m_hasNewPose[instance] = m_isDue[instance] || extrapolateInstance(instance);
+		if (!m_isDue[instance])
+		{
+			continue;
+		}
+
+		Transform* modelPose = m_ModelPoses.data() + instance * boneCount;
+		m_Skeleton.localToModel(m_LocalPoses.data() + instance * boneCount, modelPose);
+
+		if (m_updateIntervals[instance] > 1)
+		{
+			Transform* lastPose = m_LastModelPoses.data() + instance * boneCount;
+			std::copy(lastPose, lastPose + boneCount, m_PreviousModelPoses.data() + instance * boneCount);
+			std::copy(modelPose, modelPose + boneCount, lastPose);
+			m_previousEvaluationTimes[instance] = m_lastEvaluationTimes[instance];
+			m_lastEvaluationTimes[instance] = m_time;
+		}
+	}
+}
+
+void CharacterInstances::skinInstances(size_t begin, size_t end)
+{
+	size_t boneCount = m_Skeleton.m_boneCount;
+	for (size_t instance = begin; instance < end; instance++)
+	{
+		if (!m_hasNewPose[instance])
+		{
+			continue;
+		}
+
+		m_Skeleton.computeSkinningMatrices(
+			m_ModelPoses.data() + instance * boneCount, m_SkinningMatrices.data() + instance * boneCount);
+	}
+}
+
+bool CharacterInstances::extrapolateInstance(size_t instance)
+{
+	size_t			 boneCount = m_Skeleton.m_boneCount;
+	Transform const* lastPose = m_LastModelPoses.data() + instance * boneCount;
+	Transform const* previousPose = m_PreviousModelPoses.data() + instance * boneCount;
+	Transform*		 modelPose = m_ModelPoses.data() + instance * boneCount;
+
+	// A single evaluation so far holds its pose, still in m_ModelPoses and m_SkinningMatrices since that evaluation
+	double lastTime = m_lastEvaluationTimes[instance];
+	double previousTime = m_previousEvaluationTimes[instance];
+	if (previousTime < 0.0 || lastTime <= previousTime)
+	{
+		return false;
+	}
+
+	float alpha = std::min(float((m_time - previousTime) / (lastTime - previousTime)), MAX_EXTRAPOLATION);
+	for (size_t bone = 0; bone < boneCount; bone++)
+	{
+		modelPose[bone] = extrapolate(previousPose[bone], lastPose[bone], alpha);
+	}
+	return true;
+}
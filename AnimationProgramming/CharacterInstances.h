@@ -0,0 +1,140 @@
+#pragma once
+
+#include "Animation.h"
+#include "JobSystem.h"
+#include "Skeleton.h"
+#include "Transform.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Crowd of characters sharing one Skeleton and one clip set.
+// The playback state of every instance lives in flat arrays and evaluate() runs each stage of the pose pipeline
+// (sample, blend, local to model, skinning palette) over all the instances before moving to the next one.
+// Each stage is split in jobs of a few instances spread over the workers of a JobSystem; an instance is always
+// computed the same way whichever worker runs it, so the output does not depend on the worker count.
+// An instance can sample only the bones of a Skeleton level of detail and be evaluated every few frames only, its
+// model pose is extrapolated from its last two evaluations in between (see setLod).
+class CharacterInstances
+{
+  public:
+	CharacterInstances(Skeleton const& skeleton, std::vector<Animation> const& animations);
+
+	// Returns the index of the new instance, startTime is in seconds
+	size_t addInstance(int clipIndex, double startTime = 0.0);
+
+	// Negative speeds play the clip backward
+	void setPlaybackSpeed(size_t instance, float speed);
+
+	// The blend clip follows the phase of the main clip, a weight of 0 only plays the main clip
+	void setBlend(size_t instance, int blendClipIndex, float blendWeight);
+
+	// Samples only the bones of m_Skeleton.m_Lods[skeletonLod], the others hold their bind transform, and evaluates the
+	// instance every updateInterval frames, staggered over the instances. The frames in between extrapolate its last two
+	// evaluated model poses. Changing either forces an evaluation.
+	void setLod(size_t instance, int skeletonLod, int updateInterval = 1);
+
+	size_t getInstanceCount() const
+	{
+		return m_clipIndices.size();
+	}
+
+	// Advances the playback state of every instance, and the time the extrapolation is based on
+	void update(float frameTime);
+
+	// Fills the skinning matrices of every instance, to be called from the thread owning jobSystem
+	void evaluate(JobSystem& jobSystem);
+
+	// Skinning matrices of all the instances, instance after instance, m_Skeleton.m_boneCount per instance
+	std::vector<LM_::Mat4> const& getSkinningMatrices() const
+	{
+		return m_SkinningMatrices;
+	}
+
+	LM_::Mat4 const* getSkinningMatrices(size_t instance) const
+	{
+		return m_SkinningMatrices.data() + instance * m_Skeleton.m_boneCount;
+	}
+
+	// Model space pose of one instance after the last evaluate(), m_Skeleton.m_boneCount transforms
+	Transform const* getModelPose(size_t instance) const
+	{
+		return m_ModelPoses.data() + instance * m_Skeleton.m_boneCount;
+	}
+
+	// Throughput of the last evaluate()
+	double getCharactersPerMillisecond() const;
+
+	// Instances and bones sampled by the last evaluate(), the other instances were extrapolated
+	size_t getEvaluatedInstanceCount() const
+	{
+		return m_evaluatedInstanceCount;
+	}
+
+	size_t getEvaluatedBoneCount() const
+	{
+		return m_evaluatedBoneCount;
+	}
+
+  private:
+	static constexpr size_t INSTANCES_PER_JOB = 8;
+	static constexpr float	MAX_EXTRAPOLATION = 2.f; // Largest extrapolate() alpha, one interval past the last evaluation
+
+	// Poses of one instance used while sampling, one set per worker
+	struct WorkerScratch
+	{
+		std::vector<Transform> m_KeyPose;
+		std::vector<Transform> m_NextKeyPose;
+		std::vector<Transform> m_BlendPose;
+	};
+
+	// Interpolated local pose of a clip at a time in seconds, only the given bones are written
+	void samplePose(
+		WorkerScratch& scratch, int clipIndex, double clipTime, std::span<int const> bones, Transform* pose) const;
+
+	void sampleInstances(size_t begin, size_t end, WorkerScratch& scratch);
+	void blendInstances(size_t begin, size_t end, WorkerScratch& scratch);
+	void localToModelInstances(size_t begin, size_t end);
+	void skinInstances(size_t begin, size_t end);
+
+	// Model pose of an instance skipped this frame, from its last two evaluations. Returns false when a single
+	// evaluation is known and the pose is held unchanged.
+	bool extrapolateInstance(size_t instance);
+
+	Skeleton const&				  m_Skeleton;
+	std::vector<Animation> const& m_Animations;
+
+	// Playback state, one entry per instance
+	std::vector<int>	m_clipIndices;
+	std::vector<double> m_clipTimes; // Seconds, looping
+	std::vector<float>	m_playbackSpeeds;
+	std::vector<int>	m_blendClipIndices;
+	std::vector<float>	m_blendWeights;
+
+	// Level of detail, one entry per instance
+	std::vector<int>	 m_skeletonLods;
+	std::vector<int>	 m_updateIntervals;
+	std::vector<double>	 m_lastEvaluationTimes;		// Seconds of m_time, negative until evaluated with an interval above 1
+	std::vector<double>	 m_previousEvaluationTimes; // Evaluation before the last one, negative if there is none
+	std::vector<uint8_t> m_isDue;					// Whether the current evaluate() samples the instance
+	std::vector<uint8_t> m_hasNewPose;				// Whether its model pose changed, sampled or extrapolated
+
+	// Poses of every instance, instance after instance
+	std::vector<Transform> m_LocalPoses;
+	std::vector<Transform> m_ModelPoses;
+	std::vector<LM_::Mat4> m_SkinningMatrices;
+
+	// Last two evaluated model poses of every instance, kept for the instances with an update interval above 1
+	std::vector<Transform> m_LastModelPoses;
+	std::vector<Transform> m_PreviousModelPoses;
+
+	std::vector<WorkerScratch> m_Scratches;
+
+	double m_time = 0.0;	   // Seconds, sum of the update() frame times
+	size_t m_frameIndex = 0; // evaluate() calls
+
+	double m_evaluateMilliseconds = 0.0;
+	size_t m_evaluatedInstanceCount = 0;
+	size_t m_evaluatedBoneCount = 0;
+};
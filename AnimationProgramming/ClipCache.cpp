@@ -0,0 +1,300 @@
+#include "ClipCache.h"
+#include "MappedFile.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+#define CLIP_CACHE_VERSION 3
+#define CLIP_CACHE_PAGE_SIZE 4096 // Data block alignment, a multiple of AnimationClip::CLIP_ALIGNMENT
+
+namespace
+{
+constexpr char	   CLIP_CACHE_MAGIC[4] = { 'C', 'L', 'I', 'P' };
+constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+
+struct ClipCacheHeader
+{
+	char	 m_magic[4];
+	uint32_t m_version;
+	int64_t	 m_animTime; // Last write time of the source .anim
+	int64_t	 m_skelTime; // Last write time of the source .skel
+	float	 m_duration;
+	uint32_t m_keyCount;
+	uint32_t m_keyStride;
+	uint32_t m_boneCount;
+	uint32_t m_isCompressed;   // Data block of a CompressedClip instead of an AnimationClip
+	float	 m_errorThreshold; // Of the CompressedClip, 0 for an AnimationClip
+	uint32_t m_hashOffset;
+	uint32_t m_hashSlotCount; // Power of two
+	uint32_t m_namesOffset;
+	uint32_t m_namesSize;
+	uint64_t m_dataOffset;
+	uint64_t m_dataSize;
+};
+
+// Open addressing slot mapping a bone name to its track
+struct ClipCacheSlot
+{
+	uint32_t m_hash;
+	uint32_t m_track; // EMPTY_SLOT if unused
+	uint32_t m_nameOffset;
+	uint32_t m_nameLength;
+};
+
+// FNV-1a
+uint32_t hashName(const char* name, size_t length)
+{
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < length; i++)
+	{
+		hash = (hash ^ uint8_t(name[i])) * 16777619u;
+	}
+	return hash;
+}
+
+int64_t getFileTime(std::string const& path)
+{
+	std::error_code error;
+	auto			time = std::filesystem::last_write_time(path, error);
+	return error ? -1 : int64_t(time.time_since_epoch().count());
+}
+
+size_t alignUp(size_t value, size_t alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+// Header of the mapped cache if it is complete and of the current version
+ClipCacheHeader const* getHeader(MappedFile const& file)
+{
+	if (!file.isOpen() || file.getSize() < sizeof(ClipCacheHeader))
+	{
+		return nullptr;
+	}
+
+	auto header = reinterpret_cast<ClipCacheHeader const*>(file.getData());
+	if (memcmp(header->m_magic, CLIP_CACHE_MAGIC, sizeof(CLIP_CACHE_MAGIC)) || header->m_version != CLIP_CACHE_VERSION)
+	{
+		return nullptr;
+	}
+
+	bool isComplete = header->m_dataOffset % CLIP_CACHE_PAGE_SIZE == 0 &&
+					  header->m_dataOffset + header->m_dataSize <= file.getSize() &&
+					  header->m_hashOffset + uint64_t(header->m_hashSlotCount) * sizeof(ClipCacheSlot) <= file.getSize() &&
+					  uint64_t(header->m_namesOffset) + header->m_namesSize <= file.getSize() &&
+					  header->m_keyCount <= header->m_keyStride;
+	if (!isComplete)
+	{
+		return nullptr;
+	}
+
+	// The size of a raw block follows from its counts, a compressed one lists the sizes of its arrays
+	if (header->m_isCompressed)
+	{
+		bool isValid = CompressedClip::isValidBlock(
+			file.getData() + header->m_dataOffset, header->m_dataSize, header->m_keyCount, header->m_boneCount);
+		return isValid ? header : nullptr;
+	}
+
+	uint64_t expectedDataSize =
+		uint64_t(header->m_boneCount) * uint64_t(TrackStream::E_COUNT) * header->m_keyStride * sizeof(float);
+	return header->m_dataSize == expectedDataSize ? header : nullptr;
+}
+
+// Track of the given bone name, EMPTY_SLOT if the cache does not know it
+uint32_t findTrack(MappedFile const& file, ClipCacheHeader const& header, const char* name)
+{
+	size_t		length = strlen(name);
+	uint32_t	hash = hashName(name, length);
+	uint32_t	mask = header.m_hashSlotCount - 1;
+	auto		slots = reinterpret_cast<ClipCacheSlot const*>(file.getData() + header.m_hashOffset);
+	const char* names = file.getData() + header.m_namesOffset;
+
+	for (uint32_t probe = 0; probe < header.m_hashSlotCount; probe++)
+	{
+		ClipCacheSlot const& slot = slots[(hash + probe) & mask];
+		if (slot.m_track == EMPTY_SLOT)
+		{
+			break;
+		}
+
+		if (slot.m_hash == hash && slot.m_nameLength == length &&
+			uint64_t(slot.m_nameOffset) + length <= header.m_namesSize && !memcmp(names + slot.m_nameOffset, name, length))
+		{
+			return slot.m_track;
+		}
+	}
+	return EMPTY_SLOT;
+}
+
+// Bakes a cache holding the dataSize bytes of data, the clip fields of header are already set
+void writeCache(std::string const& cachePath, std::string const& animPath, std::string const& skelPath,
+				Skeleton const& skeleton, ClipCacheHeader header, void const* data)
+{
+	uint32_t slotCount = 1;
+	while (slotCount < skeleton.m_boneCount * 2)
+	{
+		slotCount *= 2;
+	}
+
+	std::vector<ClipCacheSlot> slots(slotCount, ClipCacheSlot{ 0, EMPTY_SLOT, 0, 0 });
+	std::string				   names;
+
+	for (size_t bone = 0; bone < skeleton.m_boneCount; bone++)
+	{
+		const char* name = skeleton.m_Bones[bone].m_Name;
+		size_t		length = strlen(name);
+		uint32_t	hash = hashName(name, length);
+
+		uint32_t slotIndex = hash & (slotCount - 1);
+		while (slots[slotIndex].m_track != EMPTY_SLOT)
+		{
+			slotIndex = (slotIndex + 1) & (slotCount - 1);
+		}
+		slots[slotIndex] = ClipCacheSlot{ hash, uint32_t(bone), uint32_t(names.size()), uint32_t(length) };
+		names.append(name, length);
+	}
+
+	memcpy(header.m_magic, CLIP_CACHE_MAGIC, sizeof(CLIP_CACHE_MAGIC));
+	header.m_version = CLIP_CACHE_VERSION;
+	header.m_animTime = getFileTime(animPath);
+	header.m_skelTime = getFileTime(skelPath);
+	header.m_hashOffset = uint32_t(sizeof(ClipCacheHeader));
+	header.m_hashSlotCount = slotCount;
+	header.m_namesOffset = uint32_t(header.m_hashOffset + slotCount * sizeof(ClipCacheSlot));
+	header.m_namesSize = uint32_t(names.size());
+	header.m_dataOffset = alignUp(header.m_namesOffset + names.size(), CLIP_CACHE_PAGE_SIZE);
+
+	std::vector<char> padding(header.m_dataOffset - (header.m_namesOffset + names.size()), 0);
+
+	std::error_code error;
+	std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+
+	// Written aside under a name of this process and call then renamed, so no process maps a half written cache and two
+	// processes baking the same clip do not write into the same file
+	static std::atomic<uint32_t> tempCount = 0;
+	std::string					 tempPath =
+		cachePath + "." + std::to_string(getpid()) + "." + std::to_string(tempCount++) + ".tmp";
+	{
+		std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+		stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		stream.write(reinterpret_cast<const char*>(slots.data()), slots.size() * sizeof(ClipCacheSlot));
+		stream.write(names.data(), names.size());
+		stream.write(padding.data(), padding.size());
+		stream.write(static_cast<const char*>(data), header.m_dataSize);
+		stream.close();
+
+		if (!stream)
+		{
+			std::filesystem::remove(tempPath, error);
+			throw std::runtime_error("Cannot write clip cache " + tempPath);
+		}
+	}
+
+	std::filesystem::rename(tempPath, cachePath, error);
+	if (error)
+	{
+		std::filesystem::remove(tempPath, error);
+		throw std::runtime_error("Cannot replace clip cache " + cachePath);
+	}
+}
+} // namespace
+
+std::string getClipCachePath(std::string const& animPath)
+{
+	std::filesystem::path animFile = std::filesystem::path(animPath).filename();
+	return (std::filesystem::path(CLIP_CACHE_DIR) / animFile).string() + ".clipcache";
+}
+
+std::string getSkeletonPath(std::string const& animPath)
+{
+	return std::filesystem::path(animPath).replace_extension(".skel").string();
+}
+
+bool isClipCacheUpToDate(std::string const& cachePath, std::string const& animPath, std::string const& skelPath,
+						 Skeleton const& skeleton, float errorThreshold)
+{
+	MappedFile			   file(cachePath.c_str());
+	ClipCacheHeader const* header = getHeader(file);
+	if (header == nullptr || header->m_animTime != getFileTime(animPath) || header->m_skelTime != getFileTime(skelPath) ||
+		header->m_boneCount != skeleton.m_boneCount || header->m_isCompressed != (errorThreshold > 0.f) ||
+		header->m_errorThreshold != errorThreshold)
+	{
+		return false;
+	}
+
+	// Tracks are indexed like the bones, a cache baked against another bone order is stale
+	for (size_t bone = 0; bone < skeleton.m_boneCount; bone++)
+	{
+		if (findTrack(file, *header, skeleton.m_Bones[bone].m_Name) != bone)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void writeClipCache(
+	std::string const& cachePath, std::string const& animPath, std::string const& skelPath, Skeleton const& skeleton,
+	AnimationClip const& clip)
+{
+	ClipCacheHeader header = {};
+	header.m_duration = clip.getDuration();
+	header.m_keyCount = uint32_t(clip.getKeyCount());
+	header.m_keyStride = uint32_t(clip.getKeyStride());
+	header.m_boneCount = uint32_t(clip.getBoneCount());
+	header.m_dataSize = clip.getMemorySize();
+	writeCache(cachePath, animPath, skelPath, skeleton, header, clip.getData());
+}
+
+void writeClipCache(
+	std::string const& cachePath, std::string const& animPath, std::string const& skelPath, Skeleton const& skeleton,
+	CompressedClip const& clip, float errorThreshold)
+{
+	ClipCacheHeader header = {};
+	header.m_duration = clip.getDuration();
+	header.m_keyCount = uint32_t(clip.getKeyCount());
+	header.m_keyStride = uint32_t(clip.getKeyCount());
+	header.m_boneCount = uint32_t(clip.getBoneCount());
+	header.m_isCompressed = 1;
+	header.m_errorThreshold = errorThreshold;
+	header.m_dataSize = clip.getMemorySize();
+	writeCache(cachePath, animPath, skelPath, skeleton, header, clip.getData());
+}
+
+AnimationClip mapClipCache(std::string const& cachePath)
+{
+	auto				   file = std::make_shared<MappedFile>(cachePath.c_str());
+	ClipCacheHeader const* header = getHeader(*file);
+	if (header == nullptr || header->m_isCompressed)
+	{
+		throw std::runtime_error("Invalid clip cache " + cachePath);
+	}
+
+	auto data = reinterpret_cast<float const*>(file->getData() + header->m_dataOffset);
+	return AnimationClip(file, data, header->m_keyCount, header->m_keyStride, header->m_boneCount, header->m_duration);
+}
+
+CompressedClip mapCompressedClipCache(std::string const& cachePath)
+{
+	auto				   file = std::make_shared<MappedFile>(cachePath.c_str());
+	ClipCacheHeader const* header = getHeader(*file);
+	if (header == nullptr || !header->m_isCompressed)
+	{
+		throw std::runtime_error("Invalid clip cache " + cachePath);
+	}
+
+	return CompressedClip(file, file->getData() + header->m_dataOffset);
+}
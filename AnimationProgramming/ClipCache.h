@@ -0,0 +1,44 @@
+#pragma once
+
+#include "AnimationClip.h"
+#include "CompressedClip.h"
+#include "Skeleton.h"
+
+#include <string>
+
+// Baked AnimationClip or CompressedClip, memory-mapped and used in place: loading a cached clip costs the same whatever
+// its size, and every process mapping the same cache shares its pages.
+// Layout: ClipCacheHeader, bone-name hash table, bone names, then the clip block on a page boundary.
+// A cache is stale when its version or the timestamps of its source .anim/.skel differ from the files on disk, or when
+// it was not compressed with the wanted error threshold.
+
+// Directory the caches are baked into, kept out of the resources (the CMake build points it to its binary directory)
+#ifndef CLIP_CACHE_DIR
+#define CLIP_CACHE_DIR "ClipCache/"
+#endif
+
+// Cache file of the given .anim, in CLIP_CACHE_DIR
+std::string getClipCachePath(std::string const& animPath);
+
+// Skeleton the given .anim was authored against
+std::string getSkeletonPath(std::string const& animPath);
+
+// errorThreshold is the one of the wanted CompressedClip, 0 for a raw AnimationClip
+bool isClipCacheUpToDate(std::string const& cachePath, std::string const& animPath, std::string const& skelPath,
+						 Skeleton const& skeleton, float errorThreshold = 0.f);
+
+// Bakes the clip, throws std::runtime_error if the cache cannot be written
+void writeClipCache(
+	std::string const& cachePath, std::string const& animPath, std::string const& skelPath, Skeleton const& skeleton,
+	AnimationClip const& clip);
+
+// Same for a clip compressed with errorThreshold
+void writeClipCache(
+	std::string const& cachePath, std::string const& animPath, std::string const& skelPath, Skeleton const& skeleton,
+	CompressedClip const& clip, float errorThreshold);
+
+// Clip viewing the mapped cache, throws std::runtime_error if the cache cannot be mapped
+AnimationClip mapClipCache(std::string const& cachePath);
+
+// Same for a cache baked from a CompressedClip
+CompressedClip mapCompressedClipCache(std::string const& cachePath);
@@ -0,0 +1,156 @@
+#include "ClipSampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+ClipTiming::ClipTiming(size_t keyCount, double duration)
+	: m_keyCount(keyCount), m_duration(duration), m_sampleRate(keyCount > 1 && duration > 0.0 ? (keyCount - 1) / duration : 0.0)
+{
+}
+
+double ClipTiming::wrapTime(double time) const
+{
+	if (m_duration <= 0.0)
+	{
+		return 0.0;
+	}
+
+	double wrapped = std::fmod(time, m_duration);
+	if (wrapped < 0.0)
+	{
+		wrapped += m_duration;
+	}
+
+	// fmod of a tiny negative time gives back m_duration once added
+	return wrapped < m_duration ? wrapped : 0.0;
+}
+
+double ClipTiming::clampTime(double time) const
+{
+	return std::clamp(time, 0.0, std::max(m_duration, 0.0));
+}
+
+ClipSample ClipTiming::sample(double time) const
+{
+	if (m_keyCount < 2 || m_sampleRate <= 0.0)
+	{
+		return ClipSample();
+	}
+
+	double position = std::clamp(time * m_sampleRate, 0.0, double(m_keyCount - 1));
+	size_t key = std::min(size_t(position), m_keyCount - 2);
+
+	return { key, key + 1, float(position - key) };
+}
+
+void ClipTiming::setSyncMarkers(std::vector<double> const& markers)
+{
+	double cycle = 0.0;
+	for (size_t marker = 0; marker < markers.size(); marker++)
+	{
+		if (markers[marker] < 0.0 || markers[marker] >= m_duration)
+		{
+			throw std::logic_error("Sync marker outside of the clip");
+		}
+
+		double next = markers[(marker + 1) % markers.size()];
+		cycle += next > markers[marker] ? next - markers[marker] : next - markers[marker] + m_duration;
+	}
+
+	// Markers out of order go around the clip more than once
+	if (markers.size() > 1 && std::abs(cycle - m_duration) > m_duration * 1e-6)
+	{
+		throw std::logic_error("Sync markers are not in the order of the cycle");
+	}
+
+	m_syncMarkers = markers;
+}
+
+double ClipTiming::timeToPhase(double time) const
+{
+	if (m_duration <= 0.0)
+	{
+		return 0.0;
+	}
+
+	time = wrapTime(time);
+	if (m_syncMarkers.empty())
+	{
+		return time / m_duration;
+	}
+
+	size_t markerCount = m_syncMarkers.size();
+	for (size_t marker = 0; marker < markerCount; marker++)
+	{
+		double elapsed = wrapTime(time - m_syncMarkers[marker]);
+		double span = getMarkerSpan(marker);
+		if (elapsed < span)
+		{
+			double phase = (marker + elapsed / span) / markerCount;
+			return phase < 1.0 ? phase : 0.0;
+		}
+	}
+
+	return 0.0;
+}
+
+double ClipTiming::phaseToTime(double phase) const
+{
+	if (m_syncMarkers.empty())
+	{
+		return wrapTime((phase - std::floor(phase)) * m_duration);
+	}
+
+	double markerPhase = 0.0;
+	size_t marker = findMarker(phase, markerPhase);
+	return wrapTime(m_syncMarkers[marker] + markerPhase * getMarkerSpan(marker));
+}
+
+double ClipTiming::getPhaseRate(double phase) const
+{
+	if (m_duration <= 0.0)
+	{
+		return 0.0;
+	}
+
+	if (m_syncMarkers.empty())
+	{
+		return 1.0 / m_duration;
+	}
+
+	double markerPhase = 0.0;
+	size_t marker = findMarker(phase, markerPhase);
+	return 1.0 / (m_syncMarkers.size() * getMarkerSpan(marker));
+}
+
+double ClipTiming::getMarkerSpan(size_t marker) const
+{
+	if (m_syncMarkers.size() == 1)
+	{
+		return m_duration;
+	}
+
+	double next = m_syncMarkers[(marker + 1) % m_syncMarkers.size()];
+	return next > m_syncMarkers[marker] ? next - m_syncMarkers[marker] : next - m_syncMarkers[marker] + m_duration;
+}
+
+size_t ClipTiming::findMarker(double phase, double& markerPhase) const
+{
+	double position = (phase - std::floor(phase)) * m_syncMarkers.size();
+	size_t marker = std::min(size_t(position), m_syncMarkers.size() - 1);
+
+	markerPhase = position - marker;
+	return marker;
+}
+
+void ClipPlayback::advance(ClipTiming const& timing, float frameTime)
+{
+	double time = m_time + double(frameTime) * m_speed;
+	m_time = m_isLooping ? timing.wrapTime(time) : timing.clampTime(time);
+}
+
+void ClipPlayback::syncTo(ClipTiming const& timing, ClipTiming const& fromTiming, double fromTime)
+{
+	m_time = timing.phaseToTime(fromTiming.timeToPhase(fromTime));
+}
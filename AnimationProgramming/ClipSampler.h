@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Keys a clip is sampled between
+struct ClipSample
+{
+	size_t m_key = 0;
+	size_t m_nextKey = 0;
+	float  m_alpha = 0.f; // Ratio from m_key to m_nextKey, in [0, 1]
+};
+
+// Maps clip times (seconds) to keys. The first key is at 0 and the last one at m_duration, 1 / m_sampleRate apart;
+// a looping clip goes from its last key back to time 0, so its last key is expected to match its first one.
+// Stateless and allocation free, the same timing can sample any number of playbacks of the clip.
+//
+// The phase of a time is its position in the cycle of the clip, in [0, 1). Without sync markers it is the fraction of
+// the clip played. With n markers (the foot-down events of a walk for instance), marker i is at phase i / n and the
+// phase moves linearly from one marker to the next, so clips with matching markers line up whatever their timing.
+struct ClipTiming
+{
+	ClipTiming() = default;
+	ClipTiming(size_t keyCount, double duration);
+
+	// Brings a time of any sign into [0, m_duration)
+	double wrapTime(double time) const;
+
+	// Brings a time of any sign into [0, m_duration]
+	double clampTime(double time) const;
+
+	// time is expected in [0, m_duration]
+	ClipSample sample(double time) const;
+
+	// Markers are times in [0, m_duration) in the order of the cycle: each one is after the previous one, the last
+	// one may wrap past the end of the clip. Throws std::logic_error otherwise, an empty list removes the markers.
+	void setSyncMarkers(std::vector<double> const& markers);
+
+	double timeToPhase(double time) const;
+	double phaseToTime(double phase) const;
+
+	// Phase covered in one second of playback at speed 1, which changes from one pair of markers to the next
+	double getPhaseRate(double phase) const;
+
+	size_t m_keyCount = 0;
+	double m_duration = 0.0;
+	double m_sampleRate = 0.0; // Keys per second, from the key count and the duration of the clip
+
+	std::vector<double> m_syncMarkers; // Seconds, see setSyncMarkers
+
+  private:
+	// Seconds from marker to the next one
+	double getMarkerSpan(size_t marker) const;
+
+	// Marker starting the part of the cycle containing phase, the phase past it is returned in markerPhase
+	size_t findMarker(double phase, double& markerPhase) const;
+};
+
+// Playhead of a clip, negative speeds play it backward
+struct ClipPlayback
+{
+	// Moves the playhead by frameTime * m_speed, wrapped or clamped depending on m_isLooping
+	void advance(ClipTiming const& timing, float frameTime);
+
+	// Moves the playhead to the phase of fromTime in fromTiming
+	void syncTo(ClipTiming const& timing, ClipTiming const& fromTiming, double fromTime);
+
+	ClipSample sample(ClipTiming const& timing) const
+	{
+		return timing.sample(m_time);
+	}
+
+	double m_time = 0.0; // Seconds, double so long sessions do not lose precision
+	float  m_speed = 1.f;
+	bool   m_isLooping = true;
+};
@@ -0,0 +1,480 @@
+#include "CompressedClip.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+// Virtual vertices of leaf bones still stand for some skin around the bone (centimeters)
+float const g_minimumVertexDistance = 1.f;
+float const g_smallestThreeRange = 0.70710678f; // Non-largest components of a unit quaternion are in [-1/sqrt(2), 1/sqrt(2)]
+float const g_rotationSteps = 32767.f;			// 15 bits
+float const g_translationSteps = 65535.f;		// 16 bits
+int const	g_maxEncodeAttempts = 8;			// Below the quantization error no budget fits, the last attempt is kept
+
+using PackedRotation = std::array<uint16_t, 3>;
+
+PackedRotation packRotation(LM_::Quaternion const& rotation)
+{
+	float components[4] = { rotation.m_a, rotation.m_b, rotation.m_c, rotation.m_d };
+
+	int largest = 0;
+	for (int index = 1; index < 4; index++)
+	{
+		if (std::fabs(components[index]) > std::fabs(components[largest]))
+		{
+			largest = index;
+		}
+	}
+
+	// q and -q are the same rotation, keep the largest component positive so it can be rebuilt from the others
+	float sign = components[largest] < 0.f ? -1.f : 1.f;
+
+	uint64_t bits = uint64_t(largest);
+	int		 shift = 2;
+	for (int index = 0; index < 4; index++)
+	{
+		if (index == largest)
+		{
+			continue;
+		}
+
+		float normalized = (components[index] * sign + g_smallestThreeRange) / (2.f * g_smallestThreeRange);
+		bits |= uint64_t(std::lround(std::clamp(normalized, 0.f, 1.f) * g_rotationSteps)) << shift;
+		shift += 15;
+	}
+
+	return { uint16_t(bits), uint16_t(bits >> 16), uint16_t(bits >> 32) };
+}
+
+LM_::Quaternion unpackRotation(uint16_t const* packed)
+{
+	uint64_t bits = uint64_t(packed[0]) | (uint64_t(packed[1]) << 16) | (uint64_t(packed[2]) << 32);
+	int		 largest = int(bits & 3);
+
+	float components[4];
+	float sumSquared = 0.f;
+	int	  shift = 2;
+	for (int index = 0; index < 4; index++)
+	{
+		if (index == largest)
+		{
+			continue;
+		}
+
+		float normalized = float((bits >> shift) & 0x7fff) / g_rotationSteps;
+		components[index] = normalized * 2.f * g_smallestThreeRange - g_smallestThreeRange;
+		sumSquared += components[index] * components[index];
+		shift += 15;
+	}
+	components[largest] = std::sqrt(std::max(0.f, 1.f - sumSquared));
+
+	return LM_::Quaternion(components[0], components[1], components[2], components[3]);
+}
+
+LM_::Quaternion nlerp(LM_::Quaternion const& from, LM_::Quaternion to, float alpha)
+{
+	if (from.m_a * to.m_a + from.m_b * to.m_b + from.m_c * to.m_c + from.m_d * to.m_d < 0.f)
+	{
+		to *= -1.f;
+	}
+
+	LM_::Quaternion result = from * (1.f - alpha) + to * alpha;
+	return result / result.magnitude();
+}
+
+float rotationError(LM_::Quaternion const& original, LM_::Quaternion const& rebuilt, float vertexDistance)
+{
+	LM_::Vec3 const vertices[3] = { { vertexDistance, 0.f, 0.f }, { 0.f, vertexDistance, 0.f }, { 0.f, 0.f, vertexDistance } };
+
+	float error = 0.f;
+	for (LM_::Vec3 const& vertex : vertices)
+	{
+		LM_::Vec3 delta = LM_::rotatePointVec3(original, vertex) - LM_::rotatePointVec3(rebuilt, vertex);
+		error = std::max(error, delta.magnitude());
+	}
+	return error;
+}
+
+// Greedy reduction: extends each segment while interpolating its end points rebuilds every key in between
+template <class T, class Lerp, class Error>
+std::vector<uint16_t> reduceKeys(std::vector<T> const& original, std::vector<T> const& quantized, Lerp lerp, Error error, float threshold)
+{
+	size_t keyCount = original.size();
+
+	bool isConstant = true;
+	for (size_t key = 0; key < keyCount && isConstant; key++)
+	{
+		isConstant = error(original[key], quantized[0]) <= threshold;
+	}
+	if (isConstant || keyCount < 3)
+	{
+		return isConstant ? std::vector<uint16_t>{ 0 } : std::vector<uint16_t>{ 0, uint16_t(keyCount - 1) };
+	}
+
+	std::vector<uint16_t> kept = { 0 };
+	size_t				  start = 0;
+
+	for (size_t end = start + 2; end < keyCount; end++)
+	{
+		bool fits = true;
+		for (size_t key = start + 1; key < end && fits; key++)
+		{
+			float alpha = float(key - start) / float(end - start);
+			fits = error(original[key], lerp(quantized[start], quantized[end], alpha)) <= threshold;
+		}
+
+		if (!fits)
+		{
+			start = end - 1;
+			kept.push_back(uint16_t(start));
+		}
+	}
+	kept.push_back(uint16_t(keyCount - 1));
+
+	return kept;
+}
+
+// Distance from each bone to its furthest descendant in the bind pose
+std::vector<float> computeVertexDistances(Skeleton const& skeleton)
+{
+	std::vector<Transform> localBindPose(skeleton.m_boneCount);
+	std::vector<Transform> modelBindPose(skeleton.m_boneCount);
+	std::vector<float>	   distances(skeleton.m_boneCount, g_minimumVertexDistance);
+
+	for (size_t index = 0; index < skeleton.m_boneCount; index++)
+	{
+		localBindPose[index] = skeleton.m_Bones[index].m_localTransform;
+	}
+	skeleton.localToModel(localBindPose.data(), modelBindPose.data());
+
+	for (size_t index = 0; index < skeleton.m_boneCount; index++)
+	{
+		int parent = skeleton.m_Bones[index].m_parentIndex;
+		for (int ancestor = parent; ancestor != -1; ancestor = skeleton.m_Bones[ancestor].m_parentIndex)
+		{
+			float distance = (modelBindPose[index].m_Position - modelBindPose[ancestor].m_Position).magnitude();
+			distances[ancestor] = std::max(distances[ancestor], distance);
+		}
+	}
+
+	return distances;
+}
+
+// Largest move of a virtual vertex between the original and the compressed poses, in model space
+float measureModelError(AnimationClip const& clip, CompressedClip const& compressed, Skeleton const& skeleton,
+						std::vector<float> const& vertexDistances)
+{
+	size_t boneCount = skeleton.m_boneCount;
+	if (clip.getBoneCount() != boneCount)
+	{
+		return 0.f;
+	}
+
+	std::vector<Transform> originalPose(boneCount);
+	std::vector<Transform> compressedPose(boneCount);
+	std::vector<Transform> originalModelPose(boneCount);
+	std::vector<Transform> compressedModelPose(boneCount);
+
+	float error = 0.f;
+	for (size_t key = 0; key < clip.getKeyCount(); key++)
+	{
+		for (size_t bone = 0; bone < boneCount; bone++)
+		{
+			originalPose[bone] = clip.getTransform(bone, key);
+		}
+		compressed.getPose(key, compressedPose.data());
+		skeleton.localToModel(originalPose.data(), originalModelPose.data());
+		skeleton.localToModel(compressedPose.data(), compressedModelPose.data());
+
+		for (size_t bone = 0; bone < boneCount; bone++)
+		{
+			// Bounds the move of the virtual vertices of the bone: its own move plus the one of its rotation
+			Transform const& original = originalModelPose[bone];
+			Transform const& rebuilt = compressedModelPose[bone];
+			float			 vertexError = (original.m_Position - rebuilt.m_Position).magnitude() +
+				rotationError(original.m_Rotation, rebuilt.m_Rotation, vertexDistances[bone]);
+			error = std::max(error, vertexError);
+		}
+	}
+	return error;
+}
+} // namespace
+
+CompressedClip::CompressedClip(AnimationClip const& clip, Skeleton const& skeleton, float errorThreshold)
+{
+	std::vector<float> vertexDistances = computeVertexDistances(skeleton);
+
+	// The errors of a bone and of its ancestors add up, halve the budget of every bone until the whole pose fits
+	float boneThreshold = errorThreshold;
+	for (int attempt = 0; attempt < g_maxEncodeAttempts; attempt++)
+	{
+		encode(clip, vertexDistances, boneThreshold);
+		if (boneThreshold <= 0.f || measureModelError(clip, *this, skeleton, vertexDistances) <= errorThreshold)
+		{
+			break;
+		}
+		boneThreshold *= 0.5f;
+	}
+}
+
+CompressedClip::CompressedClip(std::shared_ptr<MappedFile> mapping, void const* data) : m_Mapping(std::move(mapping))
+{
+	view(data);
+}
+
+bool CompressedClip::isValidBlock(void const* data, size_t size, size_t keyCount, size_t boneCount)
+{
+	if (size < sizeof(BlockHeader))
+	{
+		return false;
+	}
+
+	auto header = static_cast<BlockHeader const*>(data);
+	if (header->m_keyCount != keyCount || header->m_boneCount != boneCount ||
+		size != sizeof(BlockHeader) + boneCount * sizeof(Track) +
+				(uint64_t(header->m_rotationKeyCount) + header->m_translationKeyCount) * 4 * sizeof(uint16_t))
+	{
+		return false;
+	}
+
+	auto tracks = reinterpret_cast<Track const*>(header + 1);
+	return std::all_of(tracks, tracks + boneCount,
+					   [header](Track const& track)
+					   {
+						   return uint64_t(track.m_rotationOffset) + track.m_rotationKeyCount <= header->m_rotationKeyCount &&
+							   uint64_t(track.m_translationOffset) + track.m_translationKeyCount <= header->m_translationKeyCount;
+					   });
+}
+
+void CompressedClip::encode(AnimationClip const& clip, std::vector<float> const& vertexDistances, float boneThreshold)
+{
+	size_t keyCount = clip.getKeyCount();
+
+	std::vector<Track>	  tracks(clip.getBoneCount());
+	std::vector<uint16_t> allRotationKeys;
+	std::vector<uint16_t> allRotationData;
+	std::vector<uint16_t> allTranslationKeys;
+	std::vector<uint16_t> allTranslationData;
+
+	for (size_t bone = 0; bone < tracks.size(); bone++)
+	{
+		Track& track = tracks[bone];
+		float  vertexDistance = bone < vertexDistances.size() ? vertexDistances[bone] : g_minimumVertexDistance;
+
+		std::vector<LM_::Quaternion> rotations(keyCount);
+		std::vector<LM_::Quaternion> quantizedRotations(keyCount);
+		std::vector<PackedRotation>	 packedRotations(keyCount);
+		std::vector<LM_::Vec3>		 translations(keyCount);
+		std::vector<LM_::Vec3>		 quantizedTranslations(keyCount);
+
+		for (size_t key = 0; key < keyCount; key++)
+		{
+			Transform transform = clip.getTransform(bone, key);
+			rotations[key] = LM_::normalize(transform.m_Rotation);
+			packedRotations[key] = packRotation(rotations[key]);
+			quantizedRotations[key] = unpackRotation(packedRotations[key].data());
+			translations[key] = transform.m_Position;
+		}
+
+		// Fixed point translations, over the range of the track
+		for (int axis = 0; axis < 3; axis++)
+		{
+			float minimum = translations.empty() ? 0.f : translations[0][axis];
+			float maximum = minimum;
+			for (LM_::Vec3 const& translation : translations)
+			{
+				minimum = std::min(minimum, translation[axis]);
+				maximum = std::max(maximum, translation[axis]);
+			}
+			track.m_translationMin[axis] = minimum;
+			track.m_translationExtent[axis] = maximum - minimum;
+		}
+
+		std::vector<std::array<uint16_t, 3>> packedTranslations(keyCount);
+		for (size_t key = 0; key < keyCount; key++)
+		{
+			for (int axis = 0; axis < 3; axis++)
+			{
+				float extent = track.m_translationExtent[axis];
+				float normalized = extent > 0.f ? (translations[key][axis] - track.m_translationMin[axis]) / extent : 0.f;
+				packedTranslations[key][axis] = uint16_t(std::lround(normalized * g_translationSteps));
+			}
+		}
+		for (size_t key = 0; key < keyCount; key++)
+		{
+			for (int axis = 0; axis < 3; axis++)
+			{
+				quantizedTranslations[key][axis] = track.m_translationMin[axis] +
+					track.m_translationExtent[axis] * (float(packedTranslations[key][axis]) / g_translationSteps);
+			}
+		}
+
+		if (keyCount == 0)
+		{
+			continue;
+		}
+
+		std::vector<uint16_t> rotationKeys = reduceKeys(
+			rotations, quantizedRotations, nlerp,
+			[vertexDistance](LM_::Quaternion const& original, LM_::Quaternion const& rebuilt)
+			{ return rotationError(original, rebuilt, vertexDistance); },
+			boneThreshold);
+
+		std::vector<uint16_t> translationKeys = reduceKeys(
+			translations, quantizedTranslations,
+			[](LM_::Vec3 const& from, LM_::Vec3 const& to, float alpha) { return LM_::Lerp(from, to, alpha); },
+			[](LM_::Vec3 const& original, LM_::Vec3 const& rebuilt) { return (original - rebuilt).magnitude(); },
+			boneThreshold);
+
+		track.m_rotationOffset = uint32_t(allRotationKeys.size());
+		track.m_rotationKeyCount = uint32_t(rotationKeys.size());
+		for (uint16_t key : rotationKeys)
+		{
+			allRotationKeys.push_back(key);
+			allRotationData.insert(allRotationData.end(), packedRotations[key].begin(), packedRotations[key].end());
+		}
+
+		track.m_translationOffset = uint32_t(allTranslationKeys.size());
+		track.m_translationKeyCount = uint32_t(translationKeys.size());
+		for (uint16_t key : translationKeys)
+		{
+			allTranslationKeys.push_back(key);
+			allTranslationData.insert(allTranslationData.end(), packedTranslations[key].begin(), packedTranslations[key].end());
+		}
+	}
+
+	BlockHeader header = { uint32_t(keyCount), uint32_t(tracks.size()), uint32_t(allRotationKeys.size()),
+						   uint32_t(allTranslationKeys.size()), clip.getDuration() };
+	size_t		keyDataCount =
+		allRotationKeys.size() + allRotationData.size() + allTranslationKeys.size() + allTranslationData.size();
+	size_t		blockSize = sizeof(BlockHeader) + tracks.size() * sizeof(Track) + keyDataCount * sizeof(uint16_t);
+
+	m_OwnedData.assign((blockSize + sizeof(uint32_t) - 1) / sizeof(uint32_t), 0);
+	char* block = reinterpret_cast<char*>(m_OwnedData.data());
+	auto  append = [&block](void const* data, size_t size)
+	{
+		if (size != 0)
+		{
+			memcpy(block, data, size);
+			block += size;
+		}
+	};
+	append(&header, sizeof(header));
+	append(tracks.data(), tracks.size() * sizeof(Track));
+	append(allRotationKeys.data(), allRotationKeys.size() * sizeof(uint16_t));
+	append(allRotationData.data(), allRotationData.size() * sizeof(uint16_t));
+	append(allTranslationKeys.data(), allTranslationKeys.size() * sizeof(uint16_t));
+	append(allTranslationData.data(), allTranslationData.size() * sizeof(uint16_t));
+
+	view(m_OwnedData.data());
+}
+
+void CompressedClip::view(void const* data)
+{
+	auto header = static_cast<BlockHeader const*>(data);
+
+	m_keyCount = header->m_keyCount;
+	m_boneCount = header->m_boneCount;
+	m_duration = header->m_duration;
+	m_data = data;
+	m_Tracks = reinterpret_cast<Track const*>(header + 1);
+	m_rotationKeys = reinterpret_cast<uint16_t const*>(m_Tracks + m_boneCount);
+	m_rotationData = m_rotationKeys + header->m_rotationKeyCount;
+	m_translationKeys = m_rotationData + 3 * size_t(header->m_rotationKeyCount);
+	m_translationData = m_translationKeys + header->m_translationKeyCount;
+	m_memorySize = size_t(reinterpret_cast<char const*>(m_translationData + 3 * size_t(header->m_translationKeyCount)) -
+						  static_cast<char const*>(data));
+}
+
+Transform CompressedClip::getTransform(size_t boneIndex, size_t keyFrame) const
+{
+	Track const& track = m_Tracks[boneIndex];
+	return Transform(sampleTranslation(track, keyFrame), sampleRotation(track, keyFrame));
+}
+
+void CompressedClip::getPose(size_t keyFrame, Transform* pose) const
+{
+	for (size_t bone = 0; bone < m_boneCount; bone++)
+	{
+		pose[bone].m_Position = sampleTranslation(m_Tracks[bone], keyFrame);
+		pose[bone].m_Rotation = sampleRotation(m_Tracks[bone], keyFrame);
+	}
+}
+
+LM_::Quaternion CompressedClip::sampleRotation(Track const& track, size_t keyFrame) const
+{
+	if (track.m_rotationKeyCount == 0)
+	{
+		return LM_::Quaternion(1.f, 0.f, 0.f, 0.f);
+	}
+
+	uint16_t const* keys = m_rotationKeys + track.m_rotationOffset;
+	uint16_t const* next = std::upper_bound(keys, keys + track.m_rotationKeyCount, uint16_t(keyFrame));
+
+	if (next == keys)
+	{
+		return decodeRotation(track.m_rotationOffset);
+	}
+	if (next == keys + track.m_rotationKeyCount)
+	{
+		return decodeRotation(track.m_rotationOffset + track.m_rotationKeyCount - 1);
+	}
+
+	size_t previous = size_t(next - keys) - 1;
+	if (keys[previous] == keyFrame)
+	{
+		return decodeRotation(track.m_rotationOffset + previous);
+	}
+
+	float alpha = float(keyFrame - keys[previous]) / float(*next - keys[previous]);
+	return nlerp(decodeRotation(track.m_rotationOffset + previous), decodeRotation(track.m_rotationOffset + previous + 1), alpha);
+}
+
+LM_::Vec3 CompressedClip::sampleTranslation(Track const& track, size_t keyFrame) const
+{
+	if (track.m_translationKeyCount == 0)
+	{
+		return LM_::Vec3::zero();
+	}
+
+	uint16_t const* keys = m_translationKeys + track.m_translationOffset;
+	uint16_t const* next = std::upper_bound(keys, keys + track.m_translationKeyCount, uint16_t(keyFrame));
+
+	if (next == keys)
+	{
+		return decodeTranslation(track, track.m_translationOffset);
+	}
+	if (next == keys + track.m_translationKeyCount)
+	{
+		return decodeTranslation(track, track.m_translationOffset + track.m_translationKeyCount - 1);
+	}
+
+	size_t previous = size_t(next - keys) - 1;
+	if (keys[previous] == keyFrame)
+	{
+		return decodeTranslation(track, track.m_translationOffset + previous);
+	}
+
+	float alpha = float(keyFrame - keys[previous]) / float(*next - keys[previous]);
+	return LM_::Lerp(
+		decodeTranslation(track, track.m_translationOffset + previous),
+		decodeTranslation(track, track.m_translationOffset + previous + 1), alpha);
+}
+
+LM_::Quaternion CompressedClip::decodeRotation(size_t dataIndex) const
+{
+	return unpackRotation(m_rotationData + dataIndex * 3);
+}
+
+LM_::Vec3 CompressedClip::decodeTranslation(Track const& track, size_t dataIndex) const
+{
+	uint16_t const* packed = m_translationData + dataIndex * 3;
+
+	return LM_::Vec3(
+		track.m_translationMin[0] + track.m_translationExtent[0] * (float(packed[0]) / g_translationSteps),
+		track.m_translationMin[1] + track.m_translationExtent[1] * (float(packed[1]) / g_translationSteps),
+		track.m_translationMin[2] + track.m_translationExtent[2] * (float(packed[2]) / g_translationSteps));
+}
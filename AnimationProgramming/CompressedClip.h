@@ -0,0 +1,119 @@
+#pragma once
+
+#include "AnimationClip.h"
+#include "MappedFile.h"
+#include "Skeleton.h"
+#include "Transform.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Lossy, error-bounded copy of an AnimationClip:
+// - constant tracks are stored once,
+// - rotations are quantized with smallest-three (2 bits of largest component index + 3 * 15 bits, packed in 3 u16),
+// - translations are 16-bit fixed point over the range of their track,
+// - keys that linear interpolation of their neighbours rebuilds within the error threshold are dropped.
+// The error is measured in model space on virtual vertices placed at the distance of the furthest descendant
+// of each bone, so a rotation error on the pelvis is judged by how far it moves the feet. Each bone is reduced on its
+// own first, then the decompressed poses are compared with the original ones in model space, where the errors of a
+// chain of bones add up, and the per-bone threshold is tightened until no virtual vertex moves more than errorThreshold.
+// The 16-bit quantization bounds how far that goes: below a few hundredths of a unit, the tightest encoding tried is kept.
+// Like an AnimationClip, the encoded clip is one block, either owned or used in place from a mapped clip cache.
+class CompressedClip
+{
+  public:
+	CompressedClip() = default;
+	CompressedClip(AnimationClip const& clip, Skeleton const& skeleton, float errorThreshold);
+
+	// View over a block living in a mapped file, which the clip keeps alive. The block has to pass isValidBlock.
+	CompressedClip(std::shared_ptr<MappedFile> mapping, void const* data);
+
+	CompressedClip(CompressedClip&&) = default;
+	CompressedClip& operator=(CompressedClip&&) = default;
+
+	// Whether the size bytes at data are the block of a clip of keyCount keys for boneCount bones
+	static bool isValidBlock(void const* data, size_t size, size_t keyCount, size_t boneCount);
+
+	size_t getKeyCount() const
+	{
+		return m_keyCount;
+	}
+
+	size_t getBoneCount() const
+	{
+		return m_boneCount;
+	}
+
+	float getDuration() const
+	{
+		return m_duration;
+	}
+
+	bool isMapped() const
+	{
+		return m_Mapping != nullptr;
+	}
+
+	// The whole block, getMemorySize() bytes
+	void const* getData() const
+	{
+		return m_data;
+	}
+
+	Transform getTransform(size_t boneIndex, size_t keyFrame) const;
+
+	// Decompresses the transform of every bone at the given key straight into the pose buffer
+	void getPose(size_t keyFrame, Transform* pose) const;
+
+	size_t getMemorySize() const
+	{
+		return m_memorySize;
+	}
+
+  private:
+	// Start of the block, followed by the tracks then the key and data arrays of every track
+	struct BlockHeader
+	{
+		uint32_t m_keyCount;
+		uint32_t m_boneCount;
+		uint32_t m_rotationKeyCount;	// Retained rotation keys of all the tracks
+		uint32_t m_translationKeyCount; // Retained translation keys of all the tracks
+		float	 m_duration;
+	};
+
+	struct Track
+	{
+		uint32_t m_rotationOffset = 0;		// In keys, in m_rotationKeys and m_rotationData
+		uint32_t m_rotationKeyCount = 0;	// 1 for a constant track
+		uint32_t m_translationOffset = 0;	// In keys, in m_translationKeys and m_translationData
+		uint32_t m_translationKeyCount = 0; // 1 for a constant track
+		float	 m_translationMin[3] = { 0.f, 0.f, 0.f };
+		float	 m_translationExtent[3] = { 0.f, 0.f, 0.f };
+	};
+
+	// Quantizes and reduces every track of clip, each within boneThreshold on its own, into the owned block
+	void encode(AnimationClip const& clip, std::vector<float> const& vertexDistances, float boneThreshold);
+
+	// Points the arrays at the block starting at data
+	void view(void const* data);
+
+	LM_::Quaternion sampleRotation(Track const& track, size_t keyFrame) const;
+	LM_::Vec3		sampleTranslation(Track const& track, size_t keyFrame) const;
+
+	LM_::Quaternion decodeRotation(size_t dataIndex) const;
+	LM_::Vec3		decodeTranslation(Track const& track, size_t dataIndex) const;
+
+	size_t						m_keyCount = 0;
+	size_t						m_boneCount = 0;
+	float						m_duration = 0.f;
+	size_t						m_memorySize = 0;
+	void const*					m_data = nullptr;
+	Track const*				m_Tracks = nullptr;
+	uint16_t const*				m_rotationKeys = nullptr;	 // Key frame index of each retained rotation key
+	uint16_t const*				m_rotationData = nullptr;	 // 3 u16 per retained rotation key
+	uint16_t const*				m_translationKeys = nullptr; // Key frame index of each retained translation key
+	uint16_t const*				m_translationData = nullptr; // 3 u16 per retained translation key
+	std::vector<uint32_t>		m_OwnedData;
+	std::shared_ptr<MappedFile> m_Mapping;
+};
@@ -1,33 +1,228 @@
 #include "CustomSimulation.h"
 
-#define SAMPLE_RATE 30
+#ifdef HEADLESS_ENGINE
+#include "HeadlessEngine.h"
+#endif
+
 #define FPS_TARGET 0.01666666666666667 // 60fps
 #define SLOW_FACTOR 10.f
+#ifndef CLIP_ERROR_THRESHOLD
+#define CLIP_ERROR_THRESHOLD 0.1f // Model space error allowed by clip compression (cm), 0 keeps the raw clips
+#endif
+#ifndef CROWD_SIZE
+#define CROWD_SIZE 0 // Characters animated by step6, 0 plays step5 on a single character
+#endif
+#ifndef CROWD_WORKER_COUNT
+#define CROWD_WORKER_COUNT 0 // Threads evaluating the crowd and the CPU skinning, 0 uses every hardware thread
+#endif
+#define CROWD_REPORT_INTERVAL 60 // Frames between two crowd throughput reports
+#ifndef CROWD_LOD
+#define CROWD_LOD 0 // Picks the level of detail of the step6 characters from their distance to a moving camera
+#endif
+#define CROWD_SPACING 150.f // cm between two characters, lined up away from the camera
+#define CHARACTER_HEIGHT 180.f // cm, the importance of a character is its height over its distance to the camera
+#ifndef CPU_SKINNING
+#define CPU_SKINNING 0 // Also skins MESH_NAME on the CPU every frame, with the palette sent to the engine
+#endif
+#ifndef SKINNING_PALETTE
+#define SKINNING_PALETTE 0 // SkinningPalette sent to the engine, its shader has to replace skinning.vs in skinning.program
+#endif
+#ifndef MESH_SECTIONS
+#define MESH_SECTIONS 0 // Sends one palette per section of MESH_NAME holding only its bones, to the headless engine only
+#endif
+#ifndef MESH_SECTION_BONES
+#define MESH_SECTION_BONES MeshBoneRemap::MAX_PALETTE_BONES // Palette entries of a section at most
+#endif
+#define MESH_NAME "SK_Mannequin.msh"
+#define SKINNING_REPORT_INTERVAL 60 // Frames between two CPU skinning throughput reports
+#define FRAME_ARENA_SIZE 65536	 // Bytes of frame temporaries before the arena has to grow
 
 LM_::Vec3 g_Origin(0.f);
 LM_::Vec3 g_Red(1.f, 0.f, 0.f);
 LM_::Vec3 g_Green(0.f, 1.f, 0.f);
 LM_::Vec3 g_Blue(0.f, 0.f, 1.f);
 
-float g_crossFade = 0.f;
 float g_fps = 0.f;
+float g_fpsTimeAcc = 0.f;
+float g_crowdTime = 0.f;
+int	  g_crowdFrameIndex = 0;
+int	  g_skinningFrameIndex = 0;
+
+// Path of a resource file, the headless build reads them from its --resources directory
+std::string getResourcePath(const char* name)
+{
+#ifdef HEADLESS_ENGINE
+	return std::string(HeadlessGetSettings().m_resourceDirectory) + name;
+#else
+	return std::string(RESOURCE_DIR) + name;
+#endif
+}
 
 void CustomSimulation::Init()
 {
 	size_t boneCount = GetSkeletonBoneCount();
 	m_Skeleton = Skeleton(boneCount);
 
-	m_Animations.push_back(Animation("ThirdPersonWalk.anim"));
-	m_Animations.push_back(Animation("ThirdPersonRun.anim"));
+	const char* animNames[] = { "ThirdPersonWalk.anim", "ThirdPersonRun.anim" };
+
+	std::vector<std::string> animPaths;
+	std::vector<std::string> staleAnimPaths;
+	std::vector<int>		 staleAnimIndices;
+	for (size_t animIndex = 0; animIndex < std::size(animNames); animIndex++)
+	{
+		std::string animPath = getResourcePath(animNames[animIndex]);
+		if (!isClipCacheUpToDate(getClipCachePath(animPath), animPath, getSkeletonPath(animPath), m_Skeleton, CLIP_ERROR_THRESHOLD))
+		{
+			staleAnimPaths.push_back(animPath);
+			staleAnimIndices.push_back(int(animIndex));
+		}
+		animPaths.push_back(animPath);
+	}
+
+	// Bakes missing or outdated caches, compressed when CLIP_ERROR_THRESHOLD is not 0. A clip whose cache cannot be
+	// written is kept in memory instead.
+	std::vector<AnimationClip>	clips(animPaths.size());
+	std::vector<CompressedClip> compressedClips(animPaths.size());
+	std::vector<AnimationFile>	staleAnimFiles = loadAnimationFiles(staleAnimPaths);
+	for (size_t staleIndex = 0; staleIndex < staleAnimFiles.size(); staleIndex++)
+	{
+		std::string const& animPath = staleAnimPaths[staleIndex];
+		int				   animIndex = staleAnimIndices[staleIndex];
+		AnimationClip	   clip(staleAnimFiles[staleIndex], m_Skeleton);
+		CompressedClip	   compressedClip;
+		try
+		{
+			if (CLIP_ERROR_THRESHOLD > 0.f)
+			{
+				compressedClip = CompressedClip(clip, m_Skeleton, CLIP_ERROR_THRESHOLD);
+				std::cout << animNames[animIndex] << ": " << clip.getMemorySize() << " -> " << compressedClip.getMemorySize()
+						  << " bytes" << std::endl;
+				writeClipCache(getClipCachePath(animPath), animPath, getSkeletonPath(animPath), m_Skeleton, compressedClip,
+							   CLIP_ERROR_THRESHOLD);
+			}
+			else
+			{
+				writeClipCache(getClipCachePath(animPath), animPath, getSkeletonPath(animPath), m_Skeleton, clip);
+			}
+		}
+		catch (std::runtime_error const& error)
+		{
+			std::cerr << error.what() << std::endl;
+			clips[animIndex] = std::move(clip);
+			compressedClips[animIndex] = std::move(compressedClip);
+		}
+	}
+
+	m_Animations.reserve(animPaths.size());
+	for (size_t animIndex = 0; animIndex < animPaths.size(); animIndex++)
+	{
+		if (CLIP_ERROR_THRESHOLD > 0.f)
+		{
+			if (compressedClips[animIndex].getData() == nullptr)
+			{
+				compressedClips[animIndex] = mapCompressedClipCache(getClipCachePath(animPaths[animIndex]));
+			}
+			m_Animations.emplace_back(animNames[animIndex], std::move(compressedClips[animIndex]));
+			continue;
+		}
+
+		if (clips[animIndex].getData() == nullptr)
+		{
+			clips[animIndex] = mapClipCache(getClipCachePath(animPaths[animIndex]));
+		}
+		m_Animations.emplace_back(animNames[animIndex], std::move(clips[animIndex]));
+	}
 
-	for (int animIndex = 0; animIndex < m_Animations.size(); animIndex++)
+	// Buffers reused by every Update
+	m_FrameArena = FrameArena(FRAME_ARENA_SIZE);
+	m_Pose.resize(m_Skeleton.m_boneCount);
+	m_SkinMatrices.resize(m_Skeleton.m_boneCount);
+	if (!m_Skeleton.isInSourceOrder())
 	{
-		m_Animations[animIndex].initTransforms(m_Skeleton.m_boneCount);
+		// Entries of the bones left out stay zero, no vertex of the .msh is weighted on them
+		m_EnginePalette.assign(m_Skeleton.m_sourceToBone.size(), LM_::Mat4(0.f));
 	}
+	m_SkinDualQuaternions.resize((m_Skeleton.m_boneCount + 1) / 2 * 2);
+	m_SkinAffineRows.resize((m_Skeleton.m_boneCount + 3) / 4 * 4);
+	m_SkinHalfAffineRows.resize((m_Skeleton.m_boneCount + 7) / 8 * 8);
+	m_KeyPairCaches.assign(m_Animations.size(), KeyPairCache(m_Skeleton.m_boneCount));
 
-	m_Skeleton.m_inverseBindPoses = calculateMatrices(0, TransformType::E_INVERSEBINDPOSE);
+	m_Skeleton.m_inverseBindTransforms.resize(m_Skeleton.m_boneCount);
+	calculateTransforms(0, TransformType::E_INVERSEBINDPOSE, m_Skeleton.m_inverseBindTransforms);
+	m_Skeleton.m_inverseBindPoses.resize(m_Skeleton.m_boneCount);
+	LM_::toAffineMat4(getRigidTransforms(m_Skeleton.m_inverseBindTransforms.data()), m_Skeleton.m_inverseBindPoses.data(),
+					  m_Skeleton.m_boneCount);
 
 	m_globalTimeAcc = 1.f + (rand() / (RAND_MAX / (3.5f - 1.f))); // Random value between 1 and 3.5 seconds
+
+	m_Locomotion = std::make_unique<BlendTree>(m_Skeleton, m_Animations);
+	m_locomotionParameter = m_Locomotion->addParameter();
+	int locomotionSync = m_Locomotion->addSyncGroup();
+	int walk = m_Locomotion->addClip(0, 1.f, locomotionSync);
+	int run = m_Locomotion->addClip(1, 1.f, locomotionSync);
+
+	m_LocomotionStates = std::make_unique<StateMachine>(*m_Locomotion, m_Skeleton.m_boneCount);
+	int walkState = m_LocomotionStates->addState(walk);
+	int runState = m_LocomotionStates->addState(run);
+	m_LocomotionStates->addTransition(
+		walkState, runState, m_crossfadeTimeSpan, { { m_locomotionParameter, ConditionType::E_GREATER, 0.5f } });
+	m_LocomotionStates->addTransition(
+		runState, walkState, m_crossfadeTimeSpan, { { m_locomotionParameter, ConditionType::E_LESS, 0.5f } });
+
+	if (CROWD_SIZE > 0 || CPU_SKINNING)
+	{
+		m_JobSystem = std::make_unique<JobSystem>(CROWD_WORKER_COUNT);
+	}
+
+	if (CPU_SKINNING || MESH_SECTIONS)
+	{
+		// The .msh bone indices are those of the engine skeleton, m_Mesh and m_BoneRemap take the ones of m_Skeleton
+		MeshFile mesh(getResourcePath(MESH_NAME).c_str());
+		mesh.remapBones(m_Skeleton.m_sourceToBone);
+		if (CPU_SKINNING)
+		{
+			m_Mesh = std::make_unique<SkinnedMesh>(mesh);
+		}
+
+		// Engine.dll draws the mesh with its .msh bone indices and a single palette, m_BoneRemap stays empty there
+#ifdef HEADLESS_ENGINE
+		if (MESH_SECTIONS)
+		{
+			m_BoneRemap = MeshBoneRemap(mesh, MESH_SECTION_BONES);
+			std::cout << MESH_NAME << ": " << m_BoneRemap.getBones().size() << " of " << m_Skeleton.m_boneCount
+					  << " bones in " << m_BoneRemap.getSections().size() << " sections, "
+					  << m_BoneRemap.getPaletteSize() << " palette entries" << std::endl;
+		}
+#endif
+	}
+
+	if (CROWD_SIZE > 0)
+	{
+		m_Crowd = std::make_unique<CharacterInstances>(m_Skeleton, m_Animations);
+		for (int i = 0; i < CROWD_SIZE; i++)
+		{
+			int	   clipIndex = i % m_Animations.size();
+			size_t instance = m_Crowd->addInstance(clipIndex, rand() / (RAND_MAX / m_Animations[clipIndex].m_duration));
+			m_Crowd->setBlend(instance, (clipIndex + 1) % m_Animations.size(), (i % 5) / 4.f);
+		}
+
+		if (CROWD_LOD)
+		{
+			// Fingers and twist bones go first, then forearms, hands and toes
+			const char* smallBones[] = { "index_", "middle_", "pinky_", "ring_", "thumb_", "twist_" };
+			const char* farBones[] = { "index_", "middle_", "pinky_", "ring_", "thumb_", "twist_", "ball_" };
+			int			bodyLod = m_Skeleton.addLod(smallBones);
+			int			farLod = m_Skeleton.addLod(farBones, 6);
+			std::cout << "Crowd levels of detail: " << m_Skeleton.m_Lods[0].m_Bones.size() << ", "
+					  << m_Skeleton.m_Lods[bodyLod].m_Bones.size() << " and " << m_Skeleton.m_Lods[farLod].m_Bones.size()
+					  << " bones" << std::endl;
+
+			m_CrowdLod = std::make_unique<AnimationLodScheduler>(
+				std::vector<AnimationLodLevel>{ { 0.5f, 0, 1 }, { 0.15f, bodyLod, 1 }, { 0.05f, bodyLod, 2 }, { 0.f, farLod, 4 } },
+				0.02f);
+			m_CrowdImportances.resize(m_Crowd->getInstanceCount());
+		}
+	}
 }
 
 void CustomSimulation::Update(float frameTime)
@@ -38,13 +233,22 @@ void CustomSimulation::Update(float frameTime)
 	}
 	// frameTime /= SLOW_FACTOR;
 
+	m_FrameArena.reset();
+
 	drawWorldMarker();
 
 	// step1(frameTime);
 	// step2(frameTime);
 	// step3(frameTime);
 	// step4(frameTime);
-	step5(frameTime);
+	if (m_Crowd)
+	{
+		step6(frameTime);
+	}
+	else
+	{
+		step5(frameTime);
+	}
 }
 
 void CustomSimulation::drawWorldMarker()
@@ -62,88 +266,53 @@ void CustomSimulation::drawLine(
 		pEnd.m_y + pOffset.m_y, pEnd.m_z + pOffset.m_z, pColor.m_x, pColor.m_y, pColor.m_z);
 }
 
-std::vector<Transform> CustomSimulation::calculateTransforms(int animIndex, TransformType transformType, float lerpRatio)
+void CustomSimulation::calculateTransforms(int animIndex, TransformType transformType, std::span<Transform> bones)
 {
-	std::vector<Transform> bones(m_Skeleton.m_boneCount);
-	for (int index = 0; index < m_Skeleton.m_boneCount; index++)
+	size_t			 boneCount = m_Skeleton.m_boneCount;
+	Animation const& animation = m_Animations[animIndex];
+
+	if (transformType == TransformType::E_INTERPOLATEDPALETTE)
 	{
-		bones[index] = m_Skeleton.m_Bones[index].m_localTransform;
+		std::span<Transform const> localBones = m_KeyPairCaches[animIndex].sample(animation, animation.m_Playback.m_time);
+		m_Skeleton.localToModel(localBones.data(), bones.data());
+		return;
+	}
 
-		if (transformType == TransformType::E_PALETTE)
-		{
-			bones[index] = m_Animations[0].m_animFrameTransforms[m_Animations[animIndex].m_keyFrame][index] * bones[index];
-		}
-		else if (transformType == TransformType::E_INTERPOLATEDPALETTE)
-		{
-			int		  nextKeyFrame = (m_Animations[animIndex].m_keyFrame + 1) % m_Animations[animIndex].m_keyFrameCount;
-			Transform currentFrameBone =
-				m_Animations[animIndex].m_animFrameTransforms[m_Animations[animIndex].m_keyFrame][index] * bones[index];
-			Transform nextFrameBone = m_Animations[animIndex].m_animFrameTransforms[nextKeyFrame][index] * bones[index];
-			bones[index] = interpolate(currentFrameBone, nextFrameBone, lerpRatio);
-		}
-		int parent = m_Skeleton.m_Bones[index].m_parentIndex;
-		if (parent != -1)
+	std::span<Transform> localBones = m_FrameArena.allocate<Transform>(boneCount);
+	if (transformType == TransformType::E_BINDPOSE || transformType == TransformType::E_INVERSEBINDPOSE)
+	{
+		for (size_t index = 0; index < boneCount; index++)
 		{
-			bones[index] *= bones[parent];
+			localBones[index] = m_Skeleton.m_Bones[index].m_localTransform;
 		}
 	}
-	if (transformType == TransformType::E_INVERSEBINDPOSE)
+	else
 	{
-		for (int index = 0; index < bones.size(); index++)
-		{
-			bones[index] = -bones[index];
-		}
+		animation.getPose(animation.m_Playback.sample(animation.m_Timing).m_key, localBones.data());
 	}
-	return bones;
-}
 
-std::vector<LM_::Mat4> CustomSimulation::calculateMatrices(int animIndex, TransformType transformType)
-{
-	std::vector<Transform> bones = calculateTransforms(animIndex, transformType);
-	std::vector<LM_::Mat4> matrices(bones.size());
+	m_Skeleton.localToModel(localBones.data(), bones.data());
 
-	for (int index = 0; index < bones.size(); index++)
+	if (transformType == TransformType::E_INVERSEBINDPOSE)
 	{
-		matrices[index] = bones[index];
+		LM_::invert(getRigidTransforms(bones.data()), getRigidTransforms(bones.data()), bones.size());
 	}
-
-	return matrices;
 }
 
-std::vector<Transform> CustomSimulation::interpolateAnims(int anim1, int anim2, float frameTime)
+void CustomSimulation::calculateMatrices(int animIndex, TransformType transformType, std::span<LM_::Mat4> matrices)
 {
-	if (g_crossFade == 0.f)
-	{
-		float pourcentage = (m_Animations[m_playingAnim].m_keyFrame + frameTime) / m_Animations[m_playingAnim].m_keyFrameCount;
-		float frame = m_Animations[anim2].m_keyFrameCount * pourcentage;
+	std::span<Transform> bones = m_FrameArena.allocate<Transform>(m_Skeleton.m_boneCount);
+	calculateTransforms(animIndex, transformType, bones);
 
-		m_Animations[anim2].m_keyFrame = int(frame);
-		m_Animations[anim2].m_timeAcc = frame - int(frame);
-	}
-
-	updateKeyFrameTime(anim2, frameTime);
-	g_crossFade += frameTime;
-
-	std::vector<Transform> bonesPalette1 =
-		calculateTransforms(anim1, TransformType::E_INTERPOLATEDPALETTE, m_Animations[anim1].m_timeAcc * SAMPLE_RATE);
-
-	std::vector<Transform> bonesPalette2 =
-		calculateTransforms(anim2, TransformType::E_INTERPOLATEDPALETTE, m_Animations[anim2].m_timeAcc * SAMPLE_RATE);
-
-	std::vector<Transform> interpolated(bonesPalette1.size());
-	for (int i = 0; i < bonesPalette1.size(); i++)
-	{
-		interpolated[i] = interpolate(bonesPalette1[i], bonesPalette2[i], g_crossFade / m_crossfadeTimeSpan); //* 2 = / 0.5f
-	}
-
-	return interpolated;
+	LM_::toAffineMat4(getRigidTransforms(bones.data()), matrices.data(), bones.size());
 }
 
-void CustomSimulation::drawSkeleton(int animIndex, TransformType transformType, float lerpRatio)
+void CustomSimulation::drawSkeleton(int animIndex, TransformType transformType)
 {
-	std::vector<Transform> bones = calculateTransforms(animIndex, transformType, lerpRatio);
+	std::span<Transform> bones = m_FrameArena.allocate<Transform>(m_Skeleton.m_boneCount);
+	calculateTransforms(animIndex, transformType, bones);
 
-	for (int index = 0; index < bones.size(); index++)
+	for (size_t index = 0; index < bones.size(); index++)
 	{
 		int parent = m_Skeleton.m_Bones[index].m_parentIndex;
 		if (parent != -1)
@@ -155,28 +324,15 @@ void CustomSimulation::drawSkeleton(int animIndex, TransformType transformType,
 
 void CustomSimulation::updateKeyFrameTime(float frameTime)
 {
-	if (m_Animations[m_playingAnim].m_timeAcc < (1.f / SAMPLE_RATE))
-	{
-		m_Animations[m_playingAnim].m_timeAcc += frameTime;
-		g_fps += 1.f;
-	}
-	else if (m_Animations[m_playingAnim].m_keyFrame < m_Animations[m_playingAnim].m_keyFrameCount - 1)
-	{
-		m_Animations[m_playingAnim].m_timeAcc = 0.f;
-		++m_Animations[m_playingAnim].m_keyFrame;
-		g_fps += 1.f + 0.01f;
-	}
-	else
-	{
-		m_Animations[m_playingAnim].m_timeAcc = 0.f;
-		m_Animations[m_playingAnim].m_keyFrame = 0;
-		g_fps += 1.f + 0.01f;
-	}
+	updateKeyFrameTime(m_playingAnim, frameTime);
 
-	if ((g_fps - int(g_fps)) >= 0.3f)
+	g_fps += 1.f;
+	g_fpsTimeAcc += frameTime;
+	if (g_fpsTimeAcc >= 1.f)
 	{
 		std::cout << "FPS = " << int(g_fps) << std::endl;
 		g_fps = 0.f;
+		g_fpsTimeAcc -= 1.f;
 	}
 
 	m_globalTimeAcc -= frameTime;
@@ -184,20 +340,8 @@ void CustomSimulation::updateKeyFrameTime(float frameTime)
 
 void CustomSimulation::updateKeyFrameTime(int animIndex, float frameTime)
 {
-	if (m_Animations[animIndex].m_timeAcc < (1.f / SAMPLE_RATE))
-	{
-		m_Animations[animIndex].m_timeAcc += frameTime;
-	}
-	else if (m_Animations[animIndex].m_keyFrame < m_Animations[animIndex].m_keyFrameCount - 1)
-	{
-		m_Animations[animIndex].m_timeAcc = 0.f;
-		++m_Animations[animIndex].m_keyFrame;
-	}
-	else
-	{
-		m_Animations[animIndex].m_timeAcc = 0.f;
-		m_Animations[animIndex].m_keyFrame = 0;
-	}
+	Animation& animation = m_Animations[animIndex];
+	animation.m_Playback.advance(animation.m_Timing, frameTime);
 }
 
 void CustomSimulation::step1(float frameTime)
@@ -218,69 +362,220 @@ void CustomSimulation::step3(float frameTime)
 
 	drawSkeleton(m_playingAnim, TransformType::E_PALETTE);
 
-	std::vector<LM_::Mat4> bonesPalette = calculateMatrices(m_playingAnim, TransformType::E_PALETTE);
-	std::vector<LM_::Mat4> skinMatrices;
+	std::span<LM_::Mat4> bonesPalette = m_FrameArena.allocate<LM_::Mat4>(m_Skeleton.m_boneCount);
+	calculateMatrices(m_playingAnim, TransformType::E_PALETTE, bonesPalette);
 
-	skinMatrices.reserve(m_Skeleton.m_inverseBindPoses.size());
+	LM_::multiply(bonesPalette.data(), m_Skeleton.m_inverseBindPoses.data(), m_SkinMatrices.data(), m_SkinMatrices.size());
 
-	for (int i = 0; i < m_Skeleton.m_inverseBindPoses.size(); i++)
-	{
-		skinMatrices.push_back(bonesPalette[i] * m_Skeleton.m_inverseBindPoses[i]);
-	}
-
-	SetSkinningPose(&skinMatrices[0][0][0], skinMatrices.size());
+	setEnginePose(m_SkinMatrices.data(), sizeof(LM_::Mat4), m_SkinMatrices.size());
 }
 
 void CustomSimulation::step4(float frameTime)
 {
 	updateKeyFrameTime(frameTime);
 
-	drawSkeleton(0, TransformType::E_INTERPOLATEDPALETTE, m_Animations[0].m_timeAcc * SAMPLE_RATE);
-
-	std::vector<Transform> bonesPalette =
-		calculateTransforms(0, TransformType::E_INTERPOLATEDPALETTE, m_Animations[0].m_timeAcc * SAMPLE_RATE);
-	std::vector<LM_::Mat4> skinMatrices;
+	drawSkeleton(0, TransformType::E_INTERPOLATEDPALETTE);
 
-	skinMatrices.reserve(m_Skeleton.m_inverseBindPoses.size());
+	calculateTransforms(0, TransformType::E_INTERPOLATEDPALETTE, m_Pose);
 
-	for (int i = 0; i < m_Skeleton.m_inverseBindPoses.size(); i++)
-	{
-		skinMatrices.push_back(LM_::Mat4(bonesPalette[i]) * m_Skeleton.m_inverseBindPoses[i]);
-	}
+	m_Skeleton.computeSkinningMatrices(m_Pose.data(), m_SkinMatrices.data());
 
-	SetSkinningPose(&skinMatrices[0][0][0], skinMatrices.size());
+	setEnginePose(m_SkinMatrices.data(), sizeof(LM_::Mat4), m_SkinMatrices.size());
 }
 
 void CustomSimulation::step5(float frameTime)
 {
-	if (m_globalTimeAcc <= -m_crossfadeTimeSpan)
+	// Stands for the gameplay input, the state machine picks the transition
+	if (m_globalTimeAcc <= 0.f)
 	{
-		m_playingAnim = (m_playingAnim == 0 ? 1 : 0);
-		m_globalTimeAcc = 0.f;
+		m_Locomotion->setParameter(m_locomotionParameter, 1.f - m_Locomotion->getParameter(m_locomotionParameter));
 		m_globalTimeAcc = 1.f + (rand() / (RAND_MAX / (3.5f - 1.f)));
-		m_Animations[(m_playingAnim == 0 ? 1 : 0)].m_timeAcc = 0.f;
-		g_crossFade = 0.f;
 	}
 	updateKeyFrameTime(frameTime);
 
-	std::vector<Transform> bonesPalette;
-	if (m_globalTimeAcc <= 0.f && m_globalTimeAcc >= -m_crossfadeTimeSpan)
+	std::span<Transform> localPose = m_FrameArena.allocate<Transform>(m_Skeleton.m_boneCount);
+	m_LocomotionStates->evaluate(frameTime, m_FrameArena, localPose);
+	m_Skeleton.localToModel(localPose.data(), m_Pose.data());
+
+	sendSkinningPose(m_Pose.data());
+}
+
+void CustomSimulation::step6(float frameTime)
+{
+	if (m_CrowdLod)
+	{
+		// The camera walks 3m back and forth in front of the line of characters
+		g_crowdTime += frameTime;
+		float cameraOffset = 300.f * std::sin(g_crowdTime * 0.5f);
+		for (size_t instance = 0; instance < m_CrowdImportances.size(); instance++)
+		{
+			float distance = std::max(400.f + instance * CROWD_SPACING + cameraOffset, CHARACTER_HEIGHT);
+			m_CrowdImportances[instance] = CHARACTER_HEIGHT / distance;
+		}
+		m_CrowdLod->schedule(m_CrowdImportances, *m_Crowd);
+	}
+
+	m_Crowd->update(frameTime);
+	m_Crowd->evaluate(*m_JobSystem);
+
+	// The engine draws a single character, the first one of the crowd. Its skinning matrices are already computed, and
+	// sent as they are unless the mesh sections need palettes of their own
+	if (SkinningPalette(SKINNING_PALETTE) == SkinningPalette::E_MAT4 && m_BoneRemap.getSections().empty())
 	{
-		bonesPalette = (m_playingAnim == 0 ? interpolateAnims(0, 1, frameTime) : interpolateAnims(1, 0, frameTime));
+		setEnginePose(m_Crowd->getSkinningMatrices(0), sizeof(LM_::Mat4), m_Skeleton.m_boneCount);
+		skinMesh(std::span<LM_::Mat4 const>(m_Crowd->getSkinningMatrices(0), m_Skeleton.m_boneCount));
 	}
 	else
 	{
-		bonesPalette = calculateTransforms(
-			m_playingAnim, TransformType::E_INTERPOLATEDPALETTE, m_Animations[m_playingAnim].m_timeAcc * SAMPLE_RATE);
+		sendSkinningPose(m_Crowd->getModelPose(0));
 	}
 
-	std::vector<LM_::Mat4> skinMatrices;
-	skinMatrices.reserve(m_Skeleton.m_inverseBindPoses.size());
+	if (++g_crowdFrameIndex % CROWD_REPORT_INTERVAL == 0)
+	{
+		std::cout << "Crowd: " << m_Crowd->getInstanceCount() << " characters, " << m_Crowd->getCharactersPerMillisecond()
+				  << " characters/ms";
+		if (m_CrowdLod)
+		{
+			std::cout << ", " << m_Crowd->getEvaluatedInstanceCount() << " evaluated with "
+					  << m_Crowd->getEvaluatedBoneCount() << " bones";
+		}
+		std::cout << std::endl;
+	}
+}
+
+void CustomSimulation::sendSkinningPose(Transform const* modelPose)
+{
+	if (!m_BoneRemap.getSections().empty())
+	{
+		sendSectionPoses(modelPose);
+		return;
+	}
 
-	for (int i = 0; i < m_Skeleton.m_inverseBindPoses.size(); i++)
+	switch (SkinningPalette(SKINNING_PALETTE))
 	{
-		skinMatrices.push_back(LM_::Mat4(bonesPalette[i]) * m_Skeleton.m_inverseBindPoses[i]);
+	case SkinningPalette::E_MAT4:
+		m_Skeleton.computeSkinningMatrices(modelPose, m_SkinMatrices.data());
+
+		setEnginePose(m_SkinMatrices.data(), sizeof(LM_::Mat4), m_SkinMatrices.size());
+		skinMesh(m_SkinMatrices);
+		break;
+	case SkinningPalette::E_DUAL_QUATERNION:
+		m_Skeleton.computeSkinningDualQuaternions(modelPose, m_SkinDualQuaternions.data());
+
+		sendSkinningPalette(
+			m_SkinDualQuaternions.data(), m_Skeleton.m_boneCount * sizeof(LM_::DualQuaternion), m_Skeleton.m_boneCount);
+		skinMesh(m_SkinDualQuaternions);
+		break;
+	case SkinningPalette::E_AFFINE_3X4:
+		m_Skeleton.computeSkinningMatrices(modelPose, m_SkinAffineRows.data());
+
+		sendSkinningPalette(m_SkinAffineRows.data(), m_Skeleton.m_boneCount * sizeof(LM_::AffineMat3x4), m_Skeleton.m_boneCount);
+		break;
+	case SkinningPalette::E_HALF_AFFINE_3X4:
+		m_Skeleton.computeSkinningMatrices(modelPose, m_SkinHalfAffineRows.data());
+
+		sendSkinningPalette(
+			m_SkinHalfAffineRows.data(), m_Skeleton.m_boneCount * sizeof(LM_::HalfAffineMat3x4), m_Skeleton.m_boneCount);
+		break;
 	}
 
-	SetSkinningPose(&skinMatrices[0][0][0], skinMatrices.size());
+	// Only the upload of the rows is compact, the CPU skinning keeps full precision matrices
+	bool sentRows = SkinningPalette(SKINNING_PALETTE) == SkinningPalette::E_AFFINE_3X4 ||
+					SkinningPalette(SKINNING_PALETTE) == SkinningPalette::E_HALF_AFFINE_3X4;
+	if (sentRows && m_Mesh)
+	{
+		m_Skeleton.computeSkinningMatrices(modelPose, m_SkinMatrices.data());
+		skinMesh(m_SkinMatrices);
+	}
+}
+
+void CustomSimulation::sendSectionPoses(Transform const* modelPose)
+{
+	std::vector<MeshSection> const& sections = m_BoneRemap.getSections();
+	for (size_t section = 0; section < sections.size(); section++)
+	{
+		std::span<int const> bones = sections[section].m_Bones;
+		switch (SkinningPalette(SKINNING_PALETTE))
+		{
+		case SkinningPalette::E_MAT4:
+			m_Skeleton.computeSkinningMatrices(modelPose, bones, m_SkinMatrices.data());
+			sendSkinningPalette(m_SkinMatrices.data(), bones.size() * sizeof(LM_::Mat4), bones.size(), section);
+			break;
+		case SkinningPalette::E_DUAL_QUATERNION:
+			m_Skeleton.computeSkinningDualQuaternions(modelPose, bones, m_SkinDualQuaternions.data());
+			sendSkinningPalette(m_SkinDualQuaternions.data(), bones.size() * sizeof(LM_::DualQuaternion), bones.size(), section);
+			break;
+		case SkinningPalette::E_AFFINE_3X4:
+			m_Skeleton.computeSkinningMatrices(modelPose, bones, m_SkinAffineRows.data());
+			sendSkinningPalette(m_SkinAffineRows.data(), bones.size() * sizeof(LM_::AffineMat3x4), bones.size(), section);
+			break;
+		case SkinningPalette::E_HALF_AFFINE_3X4:
+			m_Skeleton.computeSkinningMatrices(modelPose, bones, m_SkinHalfAffineRows.data());
+			sendSkinningPalette(
+				m_SkinHalfAffineRows.data(), bones.size() * sizeof(LM_::HalfAffineMat3x4), bones.size(), section);
+			break;
+		}
+	}
+
+	// m_Mesh keeps the bone indices of the .msh, so the CPU skinning still takes the matrices of the whole skeleton
+	if (m_Mesh)
+	{
+		m_Skeleton.computeSkinningMatrices(modelPose, m_SkinMatrices.data());
+		skinMesh(m_SkinMatrices);
+	}
+}
+
+void CustomSimulation::sendSkinningPalette(void const* palette, size_t byteCount, size_t boneCount, size_t section)
+{
+#ifdef HEADLESS_ENGINE
+	HeadlessSetSkinningPalette(palette, byteCount, boneCount, section);
+#else
+	// Engine.dll only takes whole Mat4 and a single palette, the shader reads the bytes back in its own layout
+	(void)section;
+	setEnginePose(palette, byteCount / boneCount, boneCount);
+#endif
+}
+
+void CustomSimulation::setEnginePose(void const* palette, size_t elementSize, size_t boneCount)
+{
+	size_t byteCount = elementSize * boneCount;
+	if (!m_EnginePalette.empty())
+	{
+		auto source = static_cast<std::byte const*>(palette);
+		auto destination = reinterpret_cast<std::byte*>(m_EnginePalette.data());
+		for (size_t bone = 0; bone < boneCount; bone++)
+		{
+			std::memcpy(destination + m_Skeleton.m_Bones[bone].m_sourceIndex * elementSize, source + bone * elementSize, elementSize);
+		}
+		palette = destination;
+		byteCount = elementSize * m_Skeleton.m_sourceToBone.size();
+	}
+	SetSkinningPose(static_cast<float const*>(palette), (byteCount + sizeof(LM_::Mat4) - 1) / sizeof(LM_::Mat4));
+}
+
+void CustomSimulation::skinMesh(std::span<LM_::Mat4 const> palette)
+{
+	if (m_Mesh)
+	{
+		m_Mesh->skin(palette, *m_JobSystem);
+		reportSkinning();
+	}
+}
+
+void CustomSimulation::skinMesh(std::span<LM_::DualQuaternion const> palette)
+{
+	if (m_Mesh)
+	{
+		m_Mesh->skin(palette, *m_JobSystem);
+		reportSkinning();
+	}
+}
+
+void CustomSimulation::reportSkinning()
+{
+	if (++g_skinningFrameIndex % SKINNING_REPORT_INTERVAL == 0)
+	{
+		std::cout << "CPU skinning: " << m_Mesh->getVertexCount() << " vertices, " << m_Mesh->getVerticesPerSecond() / 1e6
+				  << " M vertices/s" << std::endl;
+	}
 }
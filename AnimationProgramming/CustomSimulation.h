@@ -6,11 +6,30 @@
 #include "Simulation.h"
 
 #include "Animation.h"
+#include "AnimationLod.h"
+#include "BlendTree.h"
 #include "Bone.h"
+#include "CharacterInstances.h"
+#include "FrameArena.h"
+#include "KeyPairCache.h"
+#include "MeshBoneRemap.h"
+#include "ClipCache.h"
 #include "Skeleton.h"
+#include "SkinnedMesh.h"
+#include "StateMachine.h"
 #include "Transform.h"
 #include "pch.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 enum class TransformType
@@ -21,6 +40,15 @@ enum class TransformType
 	E_INTERPOLATEDPALETTE,
 };
 
+// Layout of the skinning palette sent to the engine, each one drawn by its own vertex shader
+enum class SkinningPalette
+{
+	E_MAT4,			   // skinning.vs, 64 bytes per bone
+	E_DUAL_QUATERNION, // skinning_dq.vs, 32 bytes per bone
+	E_AFFINE_3X4,	   // skinning_3x4.vs, 48 bytes per bone
+	E_HALF_AFFINE_3X4, // skinning_3x4h.vs, 24 bytes per bone
+};
+
 class CustomSimulation : public ISimulation
 {
 	virtual void Init() override;
@@ -31,12 +59,14 @@ class CustomSimulation : public ISimulation
 		LM_::Vec3 const& pStart, LM_::Vec3 const& pEnd, LM_::Vec3 const& pColor,
 		LM_::Vec3 const& pOffset = LM_::Vec3::zero()) const;
 
-	std::vector<Transform> calculateTransforms(int animIndex, TransformType transformType, float lerpRatio = 0.f);
-	std::vector<LM_::Mat4> calculateMatrices(int animIndex, TransformType transformType);
-	std::vector<Transform> interpolateAnims(int anim1, int anim2, float frameTime);
+	// Write m_Skeleton.m_boneCount bones into the given span, temporaries come from m_FrameArena.
+	// Animations are sampled at the time of their m_Playback, through m_KeyPairCaches when interpolated.
+	void calculateTransforms(int animIndex, TransformType transformType, std::span<Transform> bones);
+	void calculateMatrices(int animIndex, TransformType transformType, std::span<LM_::Mat4> matrices);
 
-	void drawSkeleton(int animIndex, TransformType transformType, float lerpRatio = 0.f);
+	void drawSkeleton(int animIndex, TransformType transformType);
 
+	// Advance the playback of the playing animation (and the step timers) or of the given one
 	void updateKeyFrameTime(float frameTime);
 	void updateKeyFrameTime(int animIndex, float frameTime);
 
@@ -45,10 +75,54 @@ class CustomSimulation : public ISimulation
 	void step3(float frameTime);
 	void step4(float frameTime);
 	void step5(float frameTime);
+	void step6(float frameTime);
+
+	// Sends the skinning palette of a model pose to the engine, in the SKINNING_PALETTE layout
+	void sendSkinningPose(Transform const* modelPose);
+
+	// Sends one palette per section of m_BoneRemap, each with the bones of its section only
+	void sendSectionPoses(Transform const* modelPose);
+
+	// Sends the bytes of a palette that is not made of Mat4 or of a section, its buffer is padded to a whole number of
+	// Mat4
+	void sendSkinningPalette(void const* palette, size_t byteCount, size_t boneCount, size_t section = 0);
+
+	// SetSkinningPose with the palette entries of m_Skeleton moved to the bone indices of the engine skeleton, which
+	// Engine.dll skins the .msh with
+	void setEnginePose(void const* palette, size_t elementSize, size_t boneCount);
+
+	// Skins m_Mesh with the palette of the drawn character, when CPU_SKINNING is on
+	void skinMesh(std::span<LM_::Mat4 const> palette);
+	void skinMesh(std::span<LM_::DualQuaternion const> palette);
+	void reportSkinning();
 
 	int					   m_playingAnim = 0;
 	float				   m_globalTimeAcc = 0.f;
 	float				   m_crossfadeTimeSpan = 0.5f;
 	std::vector<Animation> m_Animations;
 	Skeleton			   m_Skeleton;
+
+	FrameArena			   m_FrameArena; // Reset at the start of every Update
+	std::vector<Transform> m_Pose;		 // Model space pose sent to the engine
+	std::vector<LM_::Mat4> m_SkinMatrices;
+	std::vector<LM_::Mat4> m_EnginePalette; // Engine bone order, only when m_Skeleton is not in it
+
+	// Compact palettes, padded to a whole number of engine Mat4
+	std::vector<LM_::DualQuaternion>	m_SkinDualQuaternions;
+	std::vector<LM_::AffineMat3x4>		m_SkinAffineRows;
+	std::vector<LM_::HalfAffineMat3x4> m_SkinHalfAffineRows;
+
+	std::vector<KeyPairCache> m_KeyPairCaches; // One per animation, for calculateTransforms
+
+	// Walk and run states of step5, m_locomotionParameter above 0.5 runs
+	std::unique_ptr<BlendTree>	  m_Locomotion;
+	std::unique_ptr<StateMachine> m_LocomotionStates;
+	int							  m_locomotionParameter = -1;
+
+	std::unique_ptr<JobSystem>			   m_JobSystem; // Workers of the crowd and of the CPU skinning
+	std::unique_ptr<CharacterInstances>	   m_Crowd;
+	std::unique_ptr<AnimationLodScheduler> m_CrowdLod; // When CROWD_LOD is on
+	std::vector<float>					   m_CrowdImportances;
+	std::unique_ptr<SkinnedMesh>		   m_Mesh;
+	MeshBoneRemap						   m_BoneRemap; // Sections of MESH_NAME when MESH_SECTIONS is on
 };
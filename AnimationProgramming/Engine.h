@@ -1,7 +1,11 @@
 #ifndef __ENGINE_H__
 #define __ENGINE_H__
 
-#ifdef ENGINE_EXPORTS
+#include <cstddef>
+
+#if !defined(_WIN32) || defined(HEADLESS_ENGINE)
+#define ENGINE_API
+#elif defined(ENGINE_EXPORTS)
 #define ENGINE_API __declspec(dllexport) 
 #else
 #define ENGINE_API __declspec(dllimport) 
@@ -0,0 +1,41 @@
+#include "FrameArena.h"
+
+#include <cstdint>
+
+FrameArena::FrameArena(size_t capacity) : m_Block(new std::byte[capacity]), m_capacity(capacity)
+{
+}
+
+void FrameArena::reset()
+{
+	if (!m_Overflows.empty())
+	{
+		m_Overflows.clear();
+		m_capacity = m_frameSize;
+		m_Block.reset(new std::byte[m_capacity]);
+	}
+
+	m_offset = 0;
+	m_frameSize = 0;
+}
+
+void* FrameArena::allocateBytes(size_t size, size_t alignment)
+{
+	uintptr_t blockStart = reinterpret_cast<uintptr_t>(m_Block.get());
+	uintptr_t start = (blockStart + m_offset + alignment - 1) / alignment * alignment;
+	size_t	  end = size_t(start - blockStart) + size;
+
+	if (end <= m_capacity)
+	{
+		m_frameSize += end - m_offset;
+		m_offset = end;
+		return reinterpret_cast<void*>(start);
+	}
+
+	// Worst case padding, the grown block does not start at the same address
+	m_frameSize += size + alignment - 1;
+
+	m_Overflows.emplace_back(new std::byte[size + alignment - 1]);
+	uintptr_t overflowStart = reinterpret_cast<uintptr_t>(m_Overflows.back().get());
+	return reinterpret_cast<void*>((overflowStart + alignment - 1) / alignment * alignment);
+}
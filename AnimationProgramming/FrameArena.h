@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+// Linear allocator for the temporaries of one frame: allocations bump an offset in a single block and reset()
+// releases all of them at once. A frame needing more than the block still gets its memory from the heap, and the
+// next reset() grows the block to the peak usage so the following frames do not allocate anymore.
+class FrameArena
+{
+  public:
+	explicit FrameArena(size_t capacity = 0);
+
+	FrameArena(FrameArena&&) = default;
+	FrameArena& operator=(FrameArena&&) = default;
+
+	// count default constructed T, valid until the next reset()
+	template<class T>
+	std::span<T> allocate(size_t count)
+	{
+		static_assert(std::is_trivially_destructible_v<T>, "FrameArena never runs destructors");
+
+		T* data = static_cast<T*>(allocateBytes(count * sizeof(T), alignof(T)));
+		std::uninitialized_default_construct_n(data, count);
+		return std::span<T>(data, count);
+	}
+
+	void reset();
+
+	size_t getCapacity() const
+	{
+		return m_capacity;
+	}
+
+  private:
+	void* allocateBytes(size_t size, size_t alignment);
+
+	std::unique_ptr<std::byte[]>			  m_Block;
+	size_t									  m_capacity = 0;
+	size_t									  m_offset = 0;
+	size_t									  m_frameSize = 0; // Bytes asked for since the last reset(), padding included
+	std::vector<std::unique_ptr<std::byte[]>> m_Overflows;
+};
@@ -0,0 +1,132 @@
+#include "Inertialization.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+constexpr float MIN_OFFSET = 1e-6f;
+
+// Splits the rotation q into an angle in [0, pi] around a unit axis
+float toAxisAngle(LM_::Quaternion q, LM_::Vec3& axis)
+{
+	if (q.m_a < 0.f)
+	{
+		q *= -1.f;
+	}
+
+	LM_::Vec3 vector = q.getVecPart();
+	float	  sine = vector.magnitude();
+	if (sine < MIN_OFFSET)
+	{
+		axis = LM_::Vec3(1.f, 0.f, 0.f);
+		return 0.f;
+	}
+
+	axis = vector * (1.f / sine);
+	return 2.f * std::atan2(sine, q.m_a);
+}
+} // namespace
+
+PoseInertializer::Curve::Curve(float offset, float velocity, float duration)
+{
+	if (offset < MIN_OFFSET || duration <= 0.f)
+	{
+		return;
+	}
+
+	// Moving away from zero would overshoot, and moving toward it fast enough ends the curve earlier
+	velocity = std::min(velocity, 0.f);
+	if (velocity < 0.f)
+	{
+		duration = std::min(duration, -5.f * offset / velocity);
+	}
+
+	float acceleration = std::max((-8.f * velocity * duration - 20.f * offset) / (duration * duration), 0.f);
+	float squared = acceleration * duration * duration;
+
+	m_duration = duration;
+	m_coefficients[0] = -(squared + 6.f * velocity * duration + 12.f * offset) / (2.f * std::pow(duration, 5.f));
+	m_coefficients[1] = (3.f * squared + 16.f * velocity * duration + 30.f * offset) / (2.f * std::pow(duration, 4.f));
+	m_coefficients[2] = -(3.f * squared + 12.f * velocity * duration + 20.f * offset) / (2.f * std::pow(duration, 3.f));
+	m_coefficients[3] = acceleration / 2.f;
+	m_coefficients[4] = velocity;
+	m_coefficients[5] = offset;
+}
+
+float PoseInertializer::Curve::evaluate(float time) const
+{
+	if (time >= m_duration)
+	{
+		return 0.f;
+	}
+
+	float value = m_coefficients[0];
+	for (int index = 1; index < 6; index++)
+	{
+		value = value * time + m_coefficients[index];
+	}
+	return value;
+}
+
+PoseInertializer::PoseInertializer(size_t boneCount) : m_Offsets(boneCount)
+{
+}
+
+void PoseInertializer::start(
+	std::span<Transform const> previousPose, std::span<Transform const> olderPose, float frameTime,
+	std::span<Transform const> targetPose, float duration)
+{
+	bool hasVelocity = frameTime > 0.f;
+
+	m_duration = 0.f;
+	for (size_t bone = 0; bone < m_Offsets.size(); bone++)
+	{
+		BoneOffset&		 boneOffset = m_Offsets[bone];
+		Transform const& previous = previousPose[bone];
+
+		LM_::Vec3 positionOffset = previous.m_Position - targetPose[bone].m_Position;
+		float	  distance = positionOffset.magnitude();
+		float	  speed = 0.f;
+		boneOffset.m_positionAxis = distance >= MIN_OFFSET ? positionOffset * (1.f / distance) : LM_::Vec3::zero();
+		if (hasVelocity)
+		{
+			speed = LM_::Vec3::dot(previous.m_Position - olderPose[bone].m_Position, boneOffset.m_positionAxis) / frameTime;
+		}
+		boneOffset.m_Position = Curve(distance, speed, duration);
+
+		float angle = toAxisAngle(previous.m_Rotation * LM_::conjugate(targetPose[bone].m_Rotation), boneOffset.m_rotationAxis);
+		float angularSpeed = 0.f;
+		if (hasVelocity)
+		{
+			LM_::Vec3 velocityAxis;
+			float	  velocityAngle = toAxisAngle(previous.m_Rotation * LM_::conjugate(olderPose[bone].m_Rotation), velocityAxis);
+			angularSpeed = velocityAngle * LM_::Vec3::dot(velocityAxis, boneOffset.m_rotationAxis) / frameTime;
+		}
+		boneOffset.m_Rotation = Curve(angle, angularSpeed, duration);
+
+		m_duration = std::max({ m_duration, boneOffset.m_Position.m_duration, boneOffset.m_Rotation.m_duration });
+	}
+}
+
+void PoseInertializer::apply(std::span<Transform> pose, float elapsed) const
+{
+	if (!isActive(elapsed))
+	{
+		return;
+	}
+
+	for (size_t bone = 0; bone < m_Offsets.size(); bone++)
+	{
+		BoneOffset const& boneOffset = m_Offsets[bone];
+
+		pose[bone].m_Position += boneOffset.m_positionAxis * boneOffset.m_Position.evaluate(elapsed);
+
+		float halfAngle = 0.5f * boneOffset.m_Rotation.evaluate(elapsed);
+		if (halfAngle != 0.f)
+		{
+			LM_::Quaternion offset(std::cos(halfAngle), boneOffset.m_rotationAxis * std::sin(halfAngle));
+			pose[bone].m_Rotation = offset * pose[bone].m_Rotation;
+		}
+	}
+}
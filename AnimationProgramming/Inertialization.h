@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Transform.h"
+
+#include <span>
+#include <vector>
+
+// Blends out the difference between the pose played before a switch of animation and the pose of the new one.
+// start() measures, for every bone, the position and rotation offsets from the new pose to the last pose output and
+// how fast they were moving, then fits each of them with the quintic of inertialization (Bollo, GDC 2016): the offset
+// keeps its velocity at first and reaches zero with no velocity nor acceleration at the end of the transition.
+// apply() only evaluates these curves, the previous animation is never sampled again.
+class PoseInertializer
+{
+  public:
+	explicit PoseInertializer(size_t boneCount = 0);
+
+	// previousPose is the last pose output and olderPose the one before it, frameTime seconds apart (0 when there is
+	// no olderPose). targetPose is the new animation. Offsets fade over duration seconds at most.
+	void start(
+		std::span<Transform const> previousPose, std::span<Transform const> olderPose, float frameTime,
+		std::span<Transform const> targetPose, float duration);
+
+	// Adds to pose the offsets left elapsed seconds after the frame of targetPose, where they are whole
+	void apply(std::span<Transform> pose, float elapsed) const;
+
+	bool isActive(float elapsed) const
+	{
+		return elapsed < m_duration;
+	}
+
+  private:
+	// Magnitude of an offset over time
+	struct Curve
+	{
+		Curve() = default;
+		Curve(float offset, float velocity, float duration);
+
+		float evaluate(float time) const;
+
+		float m_duration = 0.f;
+		float m_coefficients[6] = {}; // From t^5 down to t^0
+	};
+
+	struct BoneOffset
+	{
+		LM_::Vec3 m_positionAxis;
+		LM_::Vec3 m_rotationAxis;
+		Curve	  m_Position;
+		Curve	  m_Rotation; // Angle around m_rotationAxis
+	};
+
+	std::vector<BoneOffset> m_Offsets;
+	float					m_duration = 0.f; // Longest curve
+};
@@ -0,0 +1,177 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+namespace
+{
+// Worker of the running thread, if it belongs to a JobSystem
+thread_local JobSystem const* t_jobSystem = nullptr;
+thread_local unsigned int	  t_workerIndex = 0;
+} // namespace
+
+JobSystem::JobSystem(unsigned int workerCount)
+{
+	if (workerCount == 0)
+	{
+		workerCount = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	for (unsigned int index = 0; index < workerCount; index++)
+	{
+		m_Queues.push_back(std::make_unique<WorkerQueue>());
+	}
+
+	t_jobSystem = this;
+	t_workerIndex = 0;
+
+	m_Threads.reserve(workerCount - 1);
+	for (unsigned int index = 1; index < workerCount; index++)
+	{
+		m_Threads.emplace_back(&JobSystem::workerMain, this, index);
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_isStopping = true;
+	}
+	m_wakeUp.notify_all();
+
+	for (std::thread& thread : m_Threads)
+	{
+		thread.join();
+	}
+
+	if (t_jobSystem == this)
+	{
+		t_jobSystem = nullptr;
+	}
+}
+
+unsigned int JobSystem::getWorkerIndex() const
+{
+	return t_jobSystem == this ? t_workerIndex : 0;
+}
+
+void JobSystem::run(JobCounter& counter, JobFunction function, void* data, size_t begin, size_t end)
+{
+	Job job = { function, data, begin, end, &counter };
+	counter.m_pending++;
+
+	if (!push(getWorkerIndex(), job))
+	{
+		// Full queue, no need to defer this one
+		execute(job);
+		return;
+	}
+
+	{
+		// Taking the lock orders the push before the sleeping check of the workers
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+	}
+	m_wakeUp.notify_one();
+}
+
+void JobSystem::wait(JobCounter& counter)
+{
+	unsigned int workerIndex = getWorkerIndex();
+	while (counter.m_pending.load(std::memory_order_acquire) > 0)
+	{
+		if (!runJob(workerIndex))
+		{
+			// The remaining jobs are running on other workers
+			std::this_thread::yield();
+		}
+	}
+}
+
+bool JobSystem::push(unsigned int workerIndex, Job const& job)
+{
+	WorkerQueue&				queue = *m_Queues[workerIndex];
+	std::lock_guard<std::mutex> lock(queue.m_mutex);
+	if (queue.m_tail - queue.m_head == QUEUE_CAPACITY)
+	{
+		return false;
+	}
+
+	queue.m_jobs[queue.m_tail++ % QUEUE_CAPACITY] = job;
+	m_queuedJobs++;
+	return true;
+}
+
+bool JobSystem::pop(unsigned int workerIndex, Job& job)
+{
+	WorkerQueue&				queue = *m_Queues[workerIndex];
+	std::lock_guard<std::mutex> lock(queue.m_mutex);
+	if (queue.m_tail == queue.m_head)
+	{
+		return false;
+	}
+
+	job = queue.m_jobs[--queue.m_tail % QUEUE_CAPACITY];
+	m_queuedJobs--;
+	return true;
+}
+
+bool JobSystem::steal(unsigned int workerIndex, Job& job)
+{
+	WorkerQueue&				queue = *m_Queues[workerIndex];
+	std::lock_guard<std::mutex> lock(queue.m_mutex);
+	if (queue.m_tail == queue.m_head)
+	{
+		return false;
+	}
+
+	job = queue.m_jobs[queue.m_head++ % QUEUE_CAPACITY];
+	m_queuedJobs--;
+	return true;
+}
+
+bool JobSystem::runJob(unsigned int workerIndex)
+{
+	Job job;
+	if (pop(workerIndex, job))
+	{
+		execute(job);
+		return true;
+	}
+
+	for (size_t offset = 1; offset < m_Queues.size(); offset++)
+	{
+		if (steal(static_cast<unsigned int>((workerIndex + offset) % m_Queues.size()), job))
+		{
+			execute(job);
+			return true;
+		}
+	}
+	return false;
+}
+
+void JobSystem::execute(Job const& job)
+{
+	job.m_function(job.m_data, job.m_begin, job.m_end);
+	job.m_counter->m_pending.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::workerMain(unsigned int workerIndex)
+{
+	t_jobSystem = this;
+	t_workerIndex = workerIndex;
+
+	while (true)
+	{
+		if (runJob(workerIndex))
+		{
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_sleepMutex);
+		m_wakeUp.wait(lock, [this]() { return m_isStopping || m_queuedJobs > 0; });
+		if (m_isStopping)
+		{
+			return;
+		}
+	}
+}
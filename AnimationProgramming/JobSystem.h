@@ -0,0 +1,99 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Jobs still to finish in a fork/join group
+struct JobCounter
+{
+	std::atomic<size_t> m_pending = 0;
+};
+
+// Work-stealing scheduler: every worker owns a deque, runs its own jobs newest first and, once out of work,
+// steals the oldest jobs of the other workers. The thread creating the JobSystem is worker 0 and takes part
+// in the work while it waits for a group to finish.
+// Jobs are plain function pointers over index ranges and the deques are fixed size rings, so scheduling never
+// allocates. Jobs must not throw.
+class JobSystem
+{
+  public:
+	using JobFunction = void (*)(void* data, size_t begin, size_t end);
+
+	// 0 uses every hardware thread
+	explicit JobSystem(unsigned int workerCount = 0);
+	~JobSystem();
+
+	JobSystem(JobSystem const&) = delete;
+	JobSystem& operator=(JobSystem const&) = delete;
+
+	unsigned int getWorkerCount() const
+	{
+		return static_cast<unsigned int>(m_Queues.size());
+	}
+
+	// Index of the calling worker in [0, getWorkerCount()), 0 for threads outside of the JobSystem
+	unsigned int getWorkerIndex() const;
+
+	// Fork: queues function(data, begin, end) on the calling worker, data must outlive the job
+	void run(JobCounter& counter, JobFunction function, void* data, size_t begin, size_t end);
+
+	// Join: runs or steals jobs until every job of the counter is done
+	void wait(JobCounter& counter);
+
+	// Calls body(begin, end) over [0, count) in ranges of at most grainSize and returns once all of them are done
+	template<class Body>
+	void parallelFor(size_t count, size_t grainSize, Body const& body)
+	{
+		JobCounter counter;
+		auto	   function = [](void* data, size_t begin, size_t end) { (*static_cast<Body const*>(data))(begin, end); };
+
+		for (size_t begin = 0; begin < count; begin += grainSize)
+		{
+			run(counter, function, const_cast<Body*>(&body), begin, std::min(begin + grainSize, count));
+		}
+		wait(counter);
+	}
+
+  private:
+	static constexpr size_t QUEUE_CAPACITY = 1024;
+
+	struct Job
+	{
+		JobFunction m_function = nullptr;
+		void*		m_data = nullptr;
+		size_t		m_begin = 0;
+		size_t		m_end = 0;
+		JobCounter* m_counter = nullptr;
+	};
+
+	struct WorkerQueue
+	{
+		std::mutex m_mutex;
+		Job		   m_jobs[QUEUE_CAPACITY];
+		size_t	   m_head = 0; // Oldest job, taken by thieves
+		size_t	   m_tail = 0; // Past the newest job, taken by the owner
+	};
+
+	bool push(unsigned int workerIndex, Job const& job);
+	bool pop(unsigned int workerIndex, Job& job);
+	bool steal(unsigned int workerIndex, Job& job);
+
+	// Runs one job of the worker, or of another one, returns false if there was none
+	bool runJob(unsigned int workerIndex);
+	void execute(Job const& job);
+
+	void workerMain(unsigned int workerIndex);
+
+	std::vector<std::unique_ptr<WorkerQueue>> m_Queues;
+	std::vector<std::thread>				  m_Threads;
+	std::atomic<size_t>						  m_queuedJobs = 0;
+	std::atomic<bool>						  m_isStopping = false;
+	std::mutex								  m_sleepMutex;
+	std::condition_variable					  m_wakeUp;
+};
@@ -0,0 +1,42 @@
+#include "KeyPairCache.h"
+
+#include <utility>
+
+KeyPairCache::KeyPairCache(size_t boneCount) : m_KeyPose(boneCount), m_NextKeyPose(boneCount), m_Pose(boneCount)
+{
+}
+
+std::span<Transform const> KeyPairCache::sample(Animation const& animation, double time)
+{
+	bool isSameAnimation = &animation == m_Animation;
+	if (isSameAnimation && time == m_time)
+	{
+		return m_Pose;
+	}
+
+	ClipSample sample = animation.m_Timing.sample(time);
+	if (!isSameAnimation || sample.m_key != m_key || sample.m_nextKey != m_nextKey)
+	{
+		if (isSameAnimation && sample.m_key == m_nextKey)
+		{
+			std::swap(m_KeyPose, m_NextKeyPose);
+		}
+		else
+		{
+			animation.getPose(sample.m_key, m_KeyPose.data());
+		}
+		animation.getPose(sample.m_nextKey, m_NextKeyPose.data());
+
+		m_Animation = &animation;
+		m_key = sample.m_key;
+		m_nextKey = sample.m_nextKey;
+	}
+
+	for (size_t bone = 0; bone < m_Pose.size(); bone++)
+	{
+		m_Pose[bone] = interpolate(m_KeyPose[bone], m_NextKeyPose[bone], sample.m_alpha);
+	}
+	m_time = time;
+
+	return m_Pose;
+}
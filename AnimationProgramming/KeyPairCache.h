@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Animation.h"
+#include "Transform.h"
+
+#include <span>
+#include <vector>
+
+// Decoded poses of the two keys a playhead is between, kept from one sample to the next.
+// While the playhead stays between the same keys sampling only interpolates, moving forward to the next pair decodes
+// a single key, and sampling again at the same time returns the last pose as is.
+// Results are cached against the address of the animation, which must not move or change while cached.
+class KeyPairCache
+{
+  public:
+	explicit KeyPairCache(size_t boneCount = 0);
+
+	// Local pose of animation at time (seconds in [0, duration]), valid until the next call
+	std::span<Transform const> sample(Animation const& animation, double time);
+
+  private:
+	Animation const*	   m_Animation = nullptr;
+	size_t				   m_key = 0;
+	size_t				   m_nextKey = 0;
+	double				   m_time = 0.0;
+	std::vector<Transform> m_KeyPose;
+	std::vector<Transform> m_NextKeyPose;
+	std::vector<Transform> m_Pose;
+};
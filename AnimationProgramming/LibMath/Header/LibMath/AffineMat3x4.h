@@ -0,0 +1,22 @@
+#ifndef __LIBMATH__AFFINE_MAT3X4_H__
+#define __LIBMATH__AFFINE_MAT3X4_H__
+
+#include <cstdint>
+
+namespace LibMath
+{
+/// <summary>Affine matrix without its (0, 0, 0, 1) last row, 12 packed floats stored row after row: each row holds
+/// three rotation elements followed by a translation element, the layout shaders read as three vec4.</summary>
+struct AffineMat3x4
+{
+	float m_rows[3][4];
+};
+
+/// <summary>AffineMat3x4 in IEEE 754 half precision floats, 24 bytes.</summary>
+struct HalfAffineMat3x4
+{
+	uint16_t m_rows[3][4];
+};
+} // namespace LibMath
+
+#endif
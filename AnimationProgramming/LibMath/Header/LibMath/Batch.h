@@ -0,0 +1,169 @@
+#ifndef __LIBMATH__BATCH_H__
+#define __LIBMATH__BATCH_H__
+
+#include "LibMath/AffineMat3x4.h"
+#include "LibMath/DualQuaternion.h"
+#include "LibMath/Matrix/Mat4x4.h"
+#include "LibMath/Quaternion.h"
+#include "LibMath/Vector/Vec3.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace LibMath
+{
+/// <summary>Instruction sets the batch functions can run with, from slowest to fastest.</summary>
+enum class SimdLevel
+{
+	E_SCALAR,
+	E_SSE,
+	E_AVX2,
+};
+
+/// <summary>Strided read-only view over rigid transforms (translation and unit rotation) stored in any structure.</summary>
+struct ConstRigidTransforms
+{
+	Vec3 const*		  m_positions = nullptr;
+	Quaternion const* m_rotations = nullptr;
+	size_t			  m_stride = 0; // Bytes between two consecutive elements
+};
+
+/// <summary>Strided view over rigid transforms (translation and unit rotation) stored in any structure.</summary>
+struct RigidTransforms
+{
+	Vec3*		m_positions = nullptr;
+	Quaternion* m_rotations = nullptr;
+	size_t		m_stride = 0; // Bytes between two consecutive elements
+
+	operator ConstRigidTransforms() const
+	{
+		return { m_positions, m_rotations, m_stride };
+	}
+};
+
+/// <summary>Read-only structure of arrays vertex streams for linear blend skinning, one element per vertex in each
+/// array.</summary>
+struct ConstSkinningVertices
+{
+	float const*   m_positions[3] = {};	  // x, y and z
+	float const*   m_normals[3] = {};	  // x, y and z
+	int32_t const* m_boneIndices[4] = {}; // Palette matrix of each influence
+	float const*   m_boneWeights[4] = {}; // The weights of a vertex add up to 1
+};
+
+/// <summary>Structure of arrays streams receiving skinned vertices, one element per vertex in each array.</summary>
+struct SkinnedVertices
+{
+	float* m_positions[3] = {};
+	float* m_normals[3] = {};
+};
+
+/// <returns>Fastest instruction set supported by both the build and the running CPU.</returns>
+SimdLevel getSupportedSimdLevel(void);
+
+/// <returns>Instruction set used by the batch functions, the supported one unless overridden.</returns>
+SimdLevel getSimdLevel(void);
+
+/// <summary>Overrides the instruction set used by the batch functions, clamped to the supported one.</summary>
+/// <param name="level">: Instruction set to use.</param>
+void setSimdLevel(SimdLevel level);
+
+/// <summary>Multiplies quaternions element-wise. result may alias lhs or rhs.</summary>
+/// <param name="lhs">: Left hand side quaternions.</param>
+/// <param name="rhs">: Right hand side quaternions.</param>
+/// <param name="result">: count quaternions receiving lhs[i] * rhs[i].</param>
+/// <param name="count">: Number of quaternions.</param>
+void multiply(Quaternion const* lhs, Quaternion const* rhs, Quaternion* result, size_t count);
+
+/// <summary>Rotates points element-wise, without the normalization of rotatePointVec3. result may alias points.</summary>
+/// <param name="rotations">: Unit quaternions.</param>
+/// <param name="points">: Points to rotate.</param>
+/// <param name="result">: count points receiving rotations[i] * points[i] * conjugate(rotations[i]).</param>
+/// <param name="count">: Number of points.</param>
+void rotate(Quaternion const* rotations, Vec3 const* points, Vec3* result, size_t count);
+
+/// <summary>Expresses child transforms in the space of their parent, element-wise. result may alias child.</summary>
+/// <param name="child">: Transforms relative to their parent.</param>
+/// <param name="parent">: Parent transforms.</param>
+/// <param name="result">: Receives the parent rotation applied to the child position plus the parent position,
+/// and the parent rotation times the child rotation.</param>
+/// <param name="count">: Number of transforms.</param>
+void compose(ConstRigidTransforms const& child, ConstRigidTransforms const& parent, RigidTransforms const& result, size_t count);
+
+/// <summary>Inverts transforms element-wise. result may alias transforms.</summary>
+/// <param name="transforms">: Transforms to invert.</param>
+/// <param name="result">: Receives the conjugate rotation and the opposite of the position rotated by it.</param>
+/// <param name="count">: Number of transforms.</param>
+void invert(ConstRigidTransforms const& transforms, RigidTransforms const& result, size_t count);
+
+/// <summary>Converts transforms to affine matrices element-wise, like toAffineMat4.</summary>
+/// <param name="transforms">: Transforms to convert.</param>
+/// <param name="result">: count matrices receiving the rotation followed by the translation of each transform.</param>
+/// <param name="count">: Number of transforms.</param>
+void toAffineMat4(ConstRigidTransforms const& transforms, Mat4* result, size_t count);
+
+/// <summary>Converts transforms to unit dual quaternions element-wise.</summary>
+/// <param name="transforms">: Transforms to convert.</param>
+/// <param name="result">: count dual quaternions receiving the rotation and half the translation times it.</param>
+/// <param name="count">: Number of transforms.</param>
+void toDualQuaternions(ConstRigidTransforms const& transforms, DualQuaternion* result, size_t count);
+
+/// <summary>Converts transforms to affine matrices without their last row element-wise, the rows of toAffineMat4.
+/// </summary>
+/// <param name="transforms">: Transforms to convert.</param>
+/// <param name="result">: count matrices receiving the rotation and translation of each transform.</param>
+/// <param name="count">: Number of transforms.</param>
+void toAffineMat3x4(ConstRigidTransforms const& transforms, AffineMat3x4* result, size_t count);
+
+/// <summary>Converts floats to IEEE 754 half precision floats, rounded to nearest even. Values out of the half range
+/// become infinities.</summary>
+/// <param name="values">: Floats to convert.</param>
+/// <param name="result">: count half precision floats, bit patterns stored in 16 bits integers.</param>
+/// <param name="count">: Number of floats.</param>
+void toHalfFloats(float const* values, uint16_t* result, size_t count);
+
+/// <summary>Multiplies matrices element-wise. result may alias lhs or rhs.</summary>
+/// <param name="lhs">: Left hand side matrices.</param>
+/// <param name="rhs">: Right hand side matrices.</param>
+/// <param name="result">: count matrices receiving lhs[i] * rhs[i].</param>
+/// <param name="count">: Number of matrices.</param>
+void multiply(Mat4 const* lhs, Mat4 const* rhs, Mat4* result, size_t count);
+
+/// <summary>Inverts matrices element-wise, like Mat4::GetInverse. result may alias matrices.</summary>
+/// <param name="matrices">: Matrices to invert.</param>
+/// <param name="result">: count inverse matrices.</param>
+/// <param name="count">: Number of matrices.</param>
+void invert(Mat4 const* matrices, Mat4* result, size_t count);
+
+/// <summary>Inverts affine matrices element-wise, like Mat4::GetAffineInverse. result may alias matrices.</summary>
+/// <param name="matrices">: Matrices whose last row is (0, 0, 0, 1).</param>
+/// <param name="result">: count inverse matrices.</param>
+/// <param name="count">: Number of matrices.</param>
+void invertAffine(Mat4 const* matrices, Mat4* result, size_t count);
+
+/// <summary>Inverts rotation and translation matrices element-wise, like Mat4::GetRigidInverse. result may alias
+/// matrices.</summary>
+/// <param name="matrices">: Matrices made of a rotation followed by a translation.</param>
+/// <param name="result">: count inverse matrices.</param>
+/// <param name="count">: Number of matrices.</param>
+void invertRigid(Mat4 const* matrices, Mat4* result, size_t count);
+
+/// <summary>Skins vertices like skinning.vs: each vertex is transformed by the weighted sum of the palette matrices of
+/// its influences, normals are normalized afterwards.</summary>
+/// <param name="vertices">: Bind pose vertices.</param>
+/// <param name="palette">: Affine skinning matrices, indexed by vertices.m_boneIndices.</param>
+/// <param name="result">: Receives count skinned positions and normals, must not alias vertices.</param>
+/// <param name="count">: Number of vertices.</param>
+void skin(ConstSkinningVertices const& vertices, Mat4 const* palette, SkinnedVertices const& result, size_t count);
+
+/// <summary>Skins vertices by dual quaternion linear blending: the palette entries of the influences of each vertex are
+/// brought to the hemisphere of the first one, weighted, summed and normalized, which keeps twisted joints from
+/// collapsing like blended matrices do. Normals are normalized afterwards.</summary>
+/// <param name="vertices">: Bind pose vertices.</param>
+/// <param name="palette">: Unit dual quaternions, indexed by vertices.m_boneIndices.</param>
+/// <param name="result">: Receives count skinned positions and normals, must not alias vertices.</param>
+/// <param name="count">: Number of vertices.</param>
+void skin(ConstSkinningVertices const& vertices, DualQuaternion const* palette, SkinnedVertices const& result, size_t count);
+} // namespace LibMath
+
+#endif
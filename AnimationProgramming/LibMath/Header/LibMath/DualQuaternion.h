@@ -0,0 +1,17 @@
+#ifndef __LIBMATH__DUAL_QUATERNION_H__
+#define __LIBMATH__DUAL_QUATERNION_H__
+
+#include "LibMath/Quaternion.h"
+
+namespace LibMath
+{
+/// <summary>Rigid transform as a unit dual quaternion, 8 packed floats: m_real is the rotation and m_dual is half the
+/// translation, as a pure quaternion, times the rotation.</summary>
+struct DualQuaternion
+{
+	Quaternion m_real;
+	Quaternion m_dual;
+};
+} // namespace LibMath
+
+#endif
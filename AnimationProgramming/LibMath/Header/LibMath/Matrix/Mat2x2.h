@@ -191,7 +191,7 @@ namespace LibMath
 	template <class T = float>
 	std::ostream& operator<<(std::ostream& os, const Matrix<2, 2, T>& matrix);
 
-	using Mat2 = typename Matrix<2, 2, float>;
+	using Mat2 = Matrix<2, 2, float>;
 }
 
 #include <LibMath/Matrix/Mat2x2.hpp>
\ No newline at end of file
@@ -227,7 +227,7 @@ namespace LibMath
 	template <class T = float>
 	std::ostream& operator<<(std::ostream& os, const Matrix<3, 3, T>& matrix);
 
-	using Mat3 = typename Matrix<3, 3, float>;
+	using Mat3 = Matrix<3, 3, float>;
 }
 
 #include <LibMath/Matrix/Mat3x3.hpp>
\ No newline at end of file
@@ -104,21 +104,21 @@ namespace LibMath
 		Matrix<3, 3, T> rotate = Matrix<3, 3, T>::Identity();
 		Matrix<3, 3, T> matrix = Matrix<3, 3, T>::Identity();
 
-		matrix[1][1] = std::cosf(other[0]);
-		matrix[2][2] = std::cosf(other[0]);
+		matrix[1][1] = std::cos(other[0]);
+		matrix[2][2] = std::cos(other[0]);
 
-		matrix[2][1] = std::sinf(other[0]);
-		matrix[1][2] = -std::sinf(other[0]);
+		matrix[2][1] = std::sin(other[0]);
+		matrix[1][2] = -std::sin(other[0]);
 
 		rotate *= matrix;
 
 		matrix.ToIdentity();
 
-		matrix[0][0] = std::cosf(other[1]);
-		matrix[2][2] = std::cosf(other[1]);
+		matrix[0][0] = std::cos(other[1]);
+		matrix[2][2] = std::cos(other[1]);
 
-		matrix[0][2] = -std::sinf(other[1]);
-		matrix[2][0] = std::sinf(other[1]);
+		matrix[0][2] = -std::sin(other[1]);
+		matrix[2][0] = std::sin(other[1]);
 
 		rotate *= matrix;
 		return rotate;
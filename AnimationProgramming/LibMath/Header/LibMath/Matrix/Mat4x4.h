@@ -158,10 +158,19 @@ namespace LibMath
 		/// <returns>Cofactors determinant matrix</returns>
 		Matrix<4, 4, T> GetCofactors(void) const;
 
-		/// <summary>Calculates the inverse of the current matrix.</summary>
+		/// <summary>Calculates the inverse of the current matrix with a closed-form cofactor expansion.</summary>
 		/// <returns>Inverse matrix.</returns>
 		Matrix<4, 4, T> GetInverse(void) const;
 
+		/// <summary>Calculates the inverse of an affine matrix, whose last row is (0, 0, 0, 1).</summary>
+		/// <returns>Inverse matrix.</returns>
+		Matrix<4, 4, T> GetAffineInverse(void) const;
+
+		/// <summary>Calculates the inverse of a rotation followed by a translation: transposed rotation and
+		/// opposite of the translation rotated back.</summary>
+		/// <returns>Inverse matrix.</returns>
+		Matrix<4, 4, T> GetRigidInverse(void) const;
+
 
 
 		/* IN-CLASS OPERATORS */
@@ -244,7 +253,8 @@ namespace LibMath
 	private:
 		/* COMPONENTS */
 
-		_ColumnType m_matrix[4];
+		// Columns are 16 bytes aligned so the float operations can load them in SIMD registers directly
+		alignas(16) _ColumnType m_matrix[4];
 	};
 
 	/* OUT-OF-CLASS OPERATORS */
@@ -260,7 +270,7 @@ namespace LibMath
 	template <class T = float>
 	std::ostream& operator<<(std::ostream& os, const Matrix<4, 4, T>& matrix);
 
-	using Mat4 = typename Matrix<4, 4, float>;
+	using Mat4 = Matrix<4, 4, float>;
 }
 
 #include <LibMath/Matrix/Mat4x4.hpp>
\ No newline at end of file
@@ -3,8 +3,60 @@
 #include <LibMath/Matrix/Mat3x3.h>
 #include <LibMath/Matrix/Mat4x4.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LIBMATH_MAT4_SSE
+#include <immintrin.h>
+#endif
+
 namespace LibMath
 {
+#ifdef LIBMATH_MAT4_SSE
+	// Float paths of Matrix<4, 4, float>, on 16 bytes aligned columns of 4 floats
+	namespace Mat4SSE
+	{
+		// a * b + c, fused when the build targets FMA
+		inline __m128 MulAdd(__m128 a, __m128 b, __m128 c)
+		{
+#ifdef __FMA__
+			return _mm_fmadd_ps(a, b, c);
+#else
+			return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+		}
+
+		// Sum of the columns of matrix weighted by the components of vector
+		inline __m128 Transform(const __m128 (&columns)[4], __m128 vector)
+		{
+			__m128 result = _mm_mul_ps(columns[0], _mm_shuffle_ps(vector, vector, _MM_SHUFFLE(0, 0, 0, 0)));
+			result = MulAdd(columns[1], _mm_shuffle_ps(vector, vector, _MM_SHUFFLE(1, 1, 1, 1)), result);
+			result = MulAdd(columns[2], _mm_shuffle_ps(vector, vector, _MM_SHUFFLE(2, 2, 2, 2)), result);
+			return MulAdd(columns[3], _mm_shuffle_ps(vector, vector, _MM_SHUFFLE(3, 3, 3, 3)), result);
+		}
+
+		inline void Multiply(const float* lhs, const float* rhs, float* result)
+		{
+			__m128 columns[4] = { _mm_load_ps(lhs), _mm_load_ps(lhs + 4), _mm_load_ps(lhs + 8), _mm_load_ps(lhs + 12) };
+			__m128 rhsColumns[4] = { _mm_load_ps(rhs), _mm_load_ps(rhs + 4), _mm_load_ps(rhs + 8), _mm_load_ps(rhs + 12) };
+
+			for (int index = 0; index < 4; ++index)
+				_mm_store_ps(result + 4 * index, Transform(columns, rhsColumns[index]));
+		}
+
+		inline void Transpose(const float* matrix, float* result)
+		{
+			__m128 column0 = _mm_load_ps(matrix), column1 = _mm_load_ps(matrix + 4);
+			__m128 column2 = _mm_load_ps(matrix + 8), column3 = _mm_load_ps(matrix + 12);
+
+			_MM_TRANSPOSE4_PS(column0, column1, column2, column3);
+
+			_mm_store_ps(result, column0);
+			_mm_store_ps(result + 4, column1);
+			_mm_store_ps(result + 8, column2);
+			_mm_store_ps(result + 12, column3);
+		}
+	}
+#endif
+
 	template<class T>
 	Matrix<4, 4, T>::Matrix(T v)
 	{
@@ -106,31 +158,31 @@ namespace LibMath
 		Matrix<4, 4, T> rotate = Matrix<4, 4, T>::Identity();
 		Matrix<4, 4, T> matrix = Matrix<4, 4, T>::Identity();
 
-		matrix[1][1] = std::cosf(rotation[0]);
-		matrix[2][2] = std::cosf(rotation[0]);
+		matrix[1][1] = std::cos(rotation[0]);
+		matrix[2][2] = std::cos(rotation[0]);
 
-		matrix[2][1] = std::sinf(rotation[0]);
-		matrix[1][2] = -std::sinf(rotation[0]);
+		matrix[2][1] = std::sin(rotation[0]);
+		matrix[1][2] = -std::sin(rotation[0]);
 
 		rotate *= matrix;
 
 		matrix.ToIdentity();
 
-		matrix[0][0] = std::cosf(rotation[1]);
-		matrix[2][2] = std::cosf(rotation[1]);
+		matrix[0][0] = std::cos(rotation[1]);
+		matrix[2][2] = std::cos(rotation[1]);
 
-		matrix[0][2] = -std::sinf(rotation[1]);
-		matrix[2][0] = std::sinf(rotation[1]);
+		matrix[0][2] = -std::sin(rotation[1]);
+		matrix[2][0] = std::sin(rotation[1]);
 
 		rotate *= matrix;
 
 		matrix.ToIdentity();
 
-		matrix[0][0] = std::cosf(rotation[2]);
-		matrix[1][1] = std::cosf(rotation[2]);
+		matrix[0][0] = std::cos(rotation[2]);
+		matrix[1][1] = std::cos(rotation[2]);
 
-		matrix[0][1] = std::sinf(rotation[2]);
-		matrix[1][0] = -std::sinf(rotation[2]);
+		matrix[0][1] = std::sin(rotation[2]);
+		matrix[1][0] = -std::sin(rotation[2]);
 
 		rotate *= matrix;
 		return rotate;
@@ -264,6 +316,14 @@ namespace LibMath
 	{
 		Matrix<4, 4, T> matrix;
 
+#ifdef LIBMATH_MAT4_SSE
+		if constexpr (std::is_same_v<T, float>)
+		{
+			Mat4SSE::Transpose(&(*this)[0].m_x, &matrix[0].m_x);
+			return matrix;
+		}
+#endif
+
 		for (int index = 0; index < 4; ++index)
 			for (int jindex = 0; jindex < 4; ++jindex)
 				matrix[jindex][index] = (*this)[index][jindex];
@@ -298,10 +358,10 @@ namespace LibMath
 		Matrix<3, 3, T> matrix;
 
 		size_t zindex = 0;
-		for (int index = 0; index < 4; ++index)
+		for (size_t index = 0; index < 4; ++index)
 		{
-			int kindex = 0;
-			for (int jindex = 0; jindex < 4; ++jindex)
+			size_t kindex = 0;
+			for (size_t jindex = 0; jindex < 4; ++jindex)
 			{
 				if (index == row || jindex == column) continue;
 
@@ -350,8 +410,108 @@ namespace LibMath
 	template<class T>
 	Matrix<4, 4, T> Matrix<4, 4, T>::GetInverse(void) const
 	{
-		Matrix<4, 4, T> matrix = this->GetCofactors().ToTranspose();
-		matrix *= (1 / this->GetDeterminant());
+		const Matrix<4, 4, T>& m = *this;
+
+		// 2x2 determinants of the first two and of the last two columns, shared by all the cofactors
+		T s0 = m[0][0] * m[1][1] - m[1][0] * m[0][1];
+		T s1 = m[0][0] * m[1][2] - m[1][0] * m[0][2];
+		T s2 = m[0][0] * m[1][3] - m[1][0] * m[0][3];
+		T s3 = m[0][1] * m[1][2] - m[1][1] * m[0][2];
+		T s4 = m[0][1] * m[1][3] - m[1][1] * m[0][3];
+		T s5 = m[0][2] * m[1][3] - m[1][2] * m[0][3];
+
+		T c5 = m[2][2] * m[3][3] - m[3][2] * m[2][3];
+		T c4 = m[2][1] * m[3][3] - m[3][1] * m[2][3];
+		T c3 = m[2][1] * m[3][2] - m[3][1] * m[2][2];
+		T c2 = m[2][0] * m[3][3] - m[3][0] * m[2][3];
+		T c1 = m[2][0] * m[3][2] - m[3][0] * m[2][2];
+		T c0 = m[2][0] * m[3][1] - m[3][0] * m[2][1];
+
+		T inverseDeterminant = 1 / (s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0);
+
+		Matrix<4, 4, T> matrix;
+
+		matrix[0][0] = (m[1][1] * c5 - m[1][2] * c4 + m[1][3] * c3) * inverseDeterminant;
+		matrix[0][1] = (-m[0][1] * c5 + m[0][2] * c4 - m[0][3] * c3) * inverseDeterminant;
+		matrix[0][2] = (m[3][1] * s5 - m[3][2] * s4 + m[3][3] * s3) * inverseDeterminant;
+		matrix[0][3] = (-m[2][1] * s5 + m[2][2] * s4 - m[2][3] * s3) * inverseDeterminant;
+
+		matrix[1][0] = (-m[1][0] * c5 + m[1][2] * c2 - m[1][3] * c1) * inverseDeterminant;
+		matrix[1][1] = (m[0][0] * c5 - m[0][2] * c2 + m[0][3] * c1) * inverseDeterminant;
+		matrix[1][2] = (-m[3][0] * s5 + m[3][2] * s2 - m[3][3] * s1) * inverseDeterminant;
+		matrix[1][3] = (m[2][0] * s5 - m[2][2] * s2 + m[2][3] * s1) * inverseDeterminant;
+
+		matrix[2][0] = (m[1][0] * c4 - m[1][1] * c2 + m[1][3] * c0) * inverseDeterminant;
+		matrix[2][1] = (-m[0][0] * c4 + m[0][1] * c2 - m[0][3] * c0) * inverseDeterminant;
+		matrix[2][2] = (m[3][0] * s4 - m[3][1] * s2 + m[3][3] * s0) * inverseDeterminant;
+		matrix[2][3] = (-m[2][0] * s4 + m[2][1] * s2 - m[2][3] * s0) * inverseDeterminant;
+
+		matrix[3][0] = (-m[1][0] * c3 + m[1][1] * c1 - m[1][2] * c0) * inverseDeterminant;
+		matrix[3][1] = (m[0][0] * c3 - m[0][1] * c1 + m[0][2] * c0) * inverseDeterminant;
+		matrix[3][2] = (-m[3][0] * s3 + m[3][1] * s1 - m[3][2] * s0) * inverseDeterminant;
+		matrix[3][3] = (m[2][0] * s3 - m[2][1] * s1 + m[2][2] * s0) * inverseDeterminant;
+
+		return matrix;
+	}
+
+	template<class T>
+	Matrix<4, 4, T> Matrix<4, 4, T>::GetAffineInverse(void) const
+	{
+		const Matrix<4, 4, T>& m = *this;
+
+		// Rows of the inverse of the 3x3 part are the cross products of its columns over the determinant
+		T row0[3] = { m[1][1] * m[2][2] - m[1][2] * m[2][1],
+					  m[1][2] * m[2][0] - m[1][0] * m[2][2],
+					  m[1][0] * m[2][1] - m[1][1] * m[2][0] };
+		T row1[3] = { m[2][1] * m[0][2] - m[2][2] * m[0][1],
+					  m[2][2] * m[0][0] - m[2][0] * m[0][2],
+					  m[2][0] * m[0][1] - m[2][1] * m[0][0] };
+		T row2[3] = { m[0][1] * m[1][2] - m[0][2] * m[1][1],
+					  m[0][2] * m[1][0] - m[0][0] * m[1][2],
+					  m[0][0] * m[1][1] - m[0][1] * m[1][0] };
+
+		T inverseDeterminant = 1 / (m[0][0] * row0[0] + m[0][1] * row0[1] + m[0][2] * row0[2]);
+
+		Matrix<4, 4, T> matrix;
+
+		for (int column = 0; column < 3; ++column)
+		{
+			matrix[column][0] = row0[column] * inverseDeterminant;
+			matrix[column][1] = row1[column] * inverseDeterminant;
+			matrix[column][2] = row2[column] * inverseDeterminant;
+			matrix[column][3] = T(0);
+		}
+
+		for (int row = 0; row < 3; ++row)
+		{
+			matrix[3][row] = -(matrix[0][row] * m[3][0] + matrix[1][row] * m[3][1] + matrix[2][row] * m[3][2]);
+		}
+		matrix[3][3] = T(1);
+
+		return matrix;
+	}
+
+	template<class T>
+	Matrix<4, 4, T> Matrix<4, 4, T>::GetRigidInverse(void) const
+	{
+		const Matrix<4, 4, T>& m = *this;
+
+		Matrix<4, 4, T> matrix;
+
+		for (int column = 0; column < 3; ++column)
+		{
+			for (int row = 0; row < 3; ++row)
+			{
+				matrix[column][row] = m[row][column];
+			}
+			matrix[column][3] = T(0);
+		}
+
+		for (int row = 0; row < 3; ++row)
+		{
+			matrix[3][row] = -(m[row][0] * m[3][0] + m[row][1] * m[3][1] + m[row][2] * m[3][2]);
+		}
+		matrix[3][3] = T(1);
 
 		return matrix;
 	}
@@ -424,9 +584,17 @@ namespace LibMath
 	{
 		Matrix<4, _C, T> matrix;
 
+#ifdef LIBMATH_MAT4_SSE
+		if constexpr (std::is_same_v<T, float> && _C == 4)
+		{
+			Mat4SSE::Multiply(&(*this)[0].m_x, &rhs[0].m_x, &matrix[0].m_x);
+			return matrix;
+		}
+#endif
+
 		for (int index = 0; index < 4; ++index)
 		{
-			for (int jindex = 0; jindex < _C; ++jindex)
+			for (size_t jindex = 0; jindex < _C; ++jindex)
 			{
 				matrix[jindex][index] = std::move(T());
 				for (int kindex = 0; kindex < 4; ++kindex)
@@ -439,6 +607,15 @@ namespace LibMath
 	template<class T>
 	Matrix<4, 4, T>& Matrix<4, 4, T>::operator*=(const Matrix<4, 4, T>& rhs)
 	{
+#ifdef LIBMATH_MAT4_SSE
+		if constexpr (std::is_same_v<T, float>)
+		{
+			// Both operands are loaded before anything is stored, no temporary needed
+			Mat4SSE::Multiply(&(*this)[0].m_x, &rhs[0].m_x, &(*this)[0].m_x);
+			return *this;
+		}
+#endif
+
 		*this = std::move(this->operator*(rhs));
 		return *this;
 	}
@@ -453,7 +630,18 @@ namespace LibMath
 	template<class T>
 	Vec4 operator*(const Vec4& vec, const Matrix<4, 4, T>& matrix)
 	{
-		LibMath::Vec4 vector = LibMath::Vec4::Zero();
+		LibMath::Vec4 vector = LibMath::Vec4::zero();
+
+#ifdef LIBMATH_MAT4_SSE
+		if constexpr (std::is_same_v<T, float>)
+		{
+			const float* elements = &matrix[0].m_x;
+			__m128		 columns[4] = { _mm_load_ps(elements), _mm_load_ps(elements + 4), _mm_load_ps(elements + 8),
+										_mm_load_ps(elements + 12) };
+			_mm_storeu_ps(&vector.m_x, Mat4SSE::Transform(columns, _mm_loadu_ps(&vec.m_x)));
+			return vector;
+		}
+#endif
 
 		for (int index = 0; index < 4; ++index)
 		{
@@ -470,6 +658,17 @@ namespace LibMath
 	{
 		Vec4 result = Vec4::zero();
 
+#ifdef LIBMATH_MAT4_SSE
+		if constexpr (std::is_same_v<T, float>)
+		{
+			const float* elements = &mat[0].m_x;
+			__m128		 columns[4] = { _mm_load_ps(elements), _mm_load_ps(elements + 4), _mm_load_ps(elements + 8),
+										_mm_load_ps(elements + 12) };
+			_mm_storeu_ps(&result.m_x, Mat4SSE::Transform(columns, _mm_loadu_ps(&vec.m_x)));
+			return result;
+		}
+#endif
+
 		for (uint32_t idx = 0; idx < 4; ++idx) {
 			result[idx] = static_cast<T>(0);
 			for (uint32_t kdx = 0; kdx < 4; ++kdx)
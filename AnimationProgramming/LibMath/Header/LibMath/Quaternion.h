@@ -240,10 +240,16 @@ Vec3 rotatePointVec3(Quaternion const& rot, Vec3 const& point);
 /// <returns>Quaternion in a 4x4 matrix form.</returns>
 Mat4 toMat4(Quaternion const& quat);
 
-/// <summary>Converts a Quaternion to a rotation Mat4.</summary>
+/// <summary>Converts a Quaternion to a rotation Mat4. The quaternion does not need to be normalized.</summary>
 /// <param name="quat">: Quaternion to convert.</param>
 /// <returns>Rotation 4x4 matrix.</returns>
 Mat4 toRotationMat4(Quaternion const& quat);
+
+/// <summary>Builds the affine Mat4 of a rotation followed by a translation, without any matrix product.</summary>
+/// <param name="rotation">: Rotation, does not need to be normalized.</param>
+/// <param name="translation">: Translation.</param>
+/// <returns>Same as Mat4::Translate(translation) * toRotationMat4(rotation).</returns>
+Mat4 toAffineMat4(Quaternion const& rotation, Vec3 const& translation);
 } // namespace LibMath
 
 #endif // !__LIBMATH__QUATERNION_H__
@@ -3,6 +3,8 @@
 
 #include "Angle/Radian.h"
 
+#include <cmath>
+
 namespace LibMath
 {
 	extern float const g_pi;		// useful constant pi -> 3.141592...
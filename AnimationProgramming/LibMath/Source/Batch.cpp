@@ -0,0 +1,229 @@
+#include "LibMath/Batch.h"
+#include "BatchKernels.hpp"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LIBMATH_SSE
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+namespace LibMath
+{
+namespace BatchDetail
+{
+namespace
+{
+#ifdef LIBMATH_SSE
+struct SSEBackend
+{
+	using Reg = __m128;
+	static constexpr size_t WIDTH = 4;
+
+	static Reg set1(float value) { return _mm_set1_ps(value); }
+	static Reg add(Reg lhs, Reg rhs) { return _mm_add_ps(lhs, rhs); }
+	static Reg sub(Reg lhs, Reg rhs) { return _mm_sub_ps(lhs, rhs); }
+	static Reg mul(Reg lhs, Reg rhs) { return _mm_mul_ps(lhs, rhs); }
+	static Reg mulAdd(Reg a, Reg b, Reg c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+	static Reg div(Reg lhs, Reg rhs) { return _mm_div_ps(lhs, rhs); }
+	static Reg sqrt(Reg value) { return _mm_sqrt_ps(value); }
+	static Reg flipSign(Reg value, Reg sign) { return _mm_xor_ps(value, _mm_and_ps(sign, _mm_set1_ps(-0.f))); }
+	static Reg load(float const* first) { return _mm_loadu_ps(first); }
+	static void store(float* first, Reg value) { _mm_storeu_ps(first, value); }
+
+	static Reg gather(float const* first, size_t stride)
+	{
+		return _mm_setr_ps(
+			*first, *advance(first, stride), *advance(first, 2 * stride), *advance(first, 3 * stride));
+	}
+
+	static Reg gather(float const* base, int32_t const* offsets)
+	{
+		return _mm_setr_ps(base[offsets[0]], base[offsets[1]], base[offsets[2]], base[offsets[3]]);
+	}
+
+	static void scatter(float* first, size_t stride, Reg value)
+	{
+		alignas(16) float lanes[WIDTH];
+		_mm_store_ps(lanes, value);
+		for (size_t lane = 0; lane < WIDTH; lane++)
+		{
+			*advance(first, lane * stride) = lanes[lane];
+		}
+	}
+};
+
+// One product at a time with the columns in registers, cheaper than spreading the elements over lanes
+void multiplyMat4s(Mat4 const* lhs, Mat4 const* rhs, Mat4* result, size_t count)
+{
+	for (size_t index = 0; index < count; index++)
+	{
+		Mat4SSE::Multiply(&lhs[index][0].m_x, &rhs[index][0].m_x, &result[index][0].m_x);
+	}
+}
+
+constexpr BatchKernels makeSSEKernels(void)
+{
+	BatchKernels kernels = makeBatchKernels<SSEBackend>();
+	kernels.m_multiplyMat4 = &multiplyMat4s;
+	return kernels;
+}
+
+constexpr BatchKernels g_SSEKernels = makeSSEKernels();
+#endif
+
+constexpr BatchKernels g_ScalarKernels = makeBatchKernels<ScalarBackend>();
+
+bool cpuSupportsAVX2(void)
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	int info[4];
+	__cpuid(info, 1);
+	bool hasFMA = (info[2] & (1 << 12)) != 0;
+	bool hasOSXSave = (info[2] & (1 << 27)) != 0;
+	bool hasAVX = (info[2] & (1 << 28)) != 0;
+	bool hasF16C = (info[2] & (1 << 29)) != 0;
+	if (!hasFMA || !hasOSXSave || !hasAVX || !hasF16C || (_xgetbv(0) & 6) != 6)
+	{
+		return false;
+	}
+
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+	return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("f16c");
+#else
+	return false;
+#endif
+}
+
+BatchKernels const* getKernels(SimdLevel level)
+{
+	switch (level)
+	{
+	case SimdLevel::E_AVX2:
+		return getAVX2BatchKernels();
+	case SimdLevel::E_SSE:
+		return getSSEBatchKernels();
+	default:
+		return getScalarBatchKernels();
+	}
+}
+
+SimdLevel g_simdLevel = getSupportedSimdLevel();
+BatchKernels const* g_Kernels = getKernels(g_simdLevel);
+} // namespace
+
+BatchKernels const* getScalarBatchKernels(void)
+{
+	return &g_ScalarKernels;
+}
+
+BatchKernels const* getSSEBatchKernels(void)
+{
+#ifdef LIBMATH_SSE
+	return &g_SSEKernels;
+#else
+	return nullptr;
+#endif
+}
+} // namespace BatchDetail
+
+SimdLevel getSupportedSimdLevel(void)
+{
+	if (BatchDetail::getAVX2BatchKernels() != nullptr && BatchDetail::cpuSupportsAVX2())
+	{
+		return SimdLevel::E_AVX2;
+	}
+	if (BatchDetail::getSSEBatchKernels() != nullptr)
+	{
+		return SimdLevel::E_SSE;
+	}
+	return SimdLevel::E_SCALAR;
+}
+
+SimdLevel getSimdLevel(void)
+{
+	return BatchDetail::g_simdLevel;
+}
+
+void setSimdLevel(SimdLevel level)
+{
+	BatchDetail::g_simdLevel = std::min(level, getSupportedSimdLevel());
+	BatchDetail::g_Kernels = BatchDetail::getKernels(BatchDetail::g_simdLevel);
+}
+
+void multiply(Quaternion const* lhs, Quaternion const* rhs, Quaternion* result, size_t count)
+{
+	BatchDetail::g_Kernels->m_multiply(lhs, rhs, result, count);
+}
+
+void rotate(Quaternion const* rotations, Vec3 const* points, Vec3* result, size_t count)
+{
+	BatchDetail::g_Kernels->m_rotate(rotations, points, result, count);
+}
+
+void compose(ConstRigidTransforms const& child, ConstRigidTransforms const& parent, RigidTransforms const& result, size_t count)
+{
+	BatchDetail::g_Kernels->m_compose(child, parent, result, count);
+}
+
+void invert(ConstRigidTransforms const& transforms, RigidTransforms const& result, size_t count)
+{
+	BatchDetail::g_Kernels->m_invert(transforms, result, count);
+}
+
+void toAffineMat4(ConstRigidTransforms const& transforms, Mat4* result, size_t count)
+{
+	BatchDetail::g_Kernels->m_toAffineMat4(transforms, result, count);
+}
+
+void toDualQuaternions(ConstRigidTransforms const& transforms, DualQuaternion* result, size_t count)
+{
+	BatchDetail::g_Kernels->m_toDualQuaternion(transforms, result, count);
+}
+
+void toAffineMat3x4(ConstRigidTransforms const& transforms, AffineMat3x4* result, size_t count)
+{
+	BatchDetail::g_Kernels->m_toAffineMat3x4(transforms, result, count);
+}
+
+void toHalfFloats(float const* values, uint16_t* result, size_t count)
+{
+	BatchDetail::g_Kernels->m_toHalfFloats(values, result, count);
+}
+
+void multiply(Mat4 const* lhs, Mat4 const* rhs, Mat4* result, size_t count)
+{
+	BatchDetail::g_Kernels->m_multiplyMat4(lhs, rhs, result, count);
+}
+
+void invert(Mat4 const* matrices, Mat4* result, size_t count)
+{
+	BatchDetail::g_Kernels->m_inverse(matrices, result, count);
+}
+
+void invertAffine(Mat4 const* matrices, Mat4* result, size_t count)
+{
+	BatchDetail::g_Kernels->m_affineInverse(matrices, result, count);
+}
+
+void invertRigid(Mat4 const* matrices, Mat4* result, size_t count)
+{
+	BatchDetail::g_Kernels->m_rigidInverse(matrices, result, count);
+}
+
+void skin(ConstSkinningVertices const& vertices, Mat4 const* palette, SkinnedVertices const& result, size_t count)
+{
+	BatchDetail::g_Kernels->m_skin(vertices, palette, result, count);
+}
+
+void skin(ConstSkinningVertices const& vertices, DualQuaternion const* palette, SkinnedVertices const& result, size_t count)
+{
+	BatchDetail::g_Kernels->m_skinDualQuaternion(vertices, palette, result, count);
+}
+} // namespace LibMath
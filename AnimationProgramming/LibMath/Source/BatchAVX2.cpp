@@ -0,0 +1,117 @@
+// Built with AVX2, FMA and F16C enabled (see CMakeLists.txt, /arch:AVX2 in AnimationProgramming.vcxproj), only called
+// when the CPU reports all three
+#include "LibMath/Batch.h"
+#include "BatchKernels.hpp"
+
+#if (defined(__AVX2__) && defined(__FMA__) && defined(__F16C__)) || (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)))
+#define LIBMATH_AVX2
+#include <immintrin.h>
+#endif
+
+namespace LibMath
+{
+namespace BatchDetail
+{
+#ifdef LIBMATH_AVX2
+namespace
+{
+struct AVX2Backend
+{
+	using Reg = __m256;
+	static constexpr size_t WIDTH = 8;
+
+	static Reg set1(float value) { return _mm256_set1_ps(value); }
+	static Reg add(Reg lhs, Reg rhs) { return _mm256_add_ps(lhs, rhs); }
+	static Reg sub(Reg lhs, Reg rhs) { return _mm256_sub_ps(lhs, rhs); }
+	static Reg mul(Reg lhs, Reg rhs) { return _mm256_mul_ps(lhs, rhs); }
+	static Reg mulAdd(Reg a, Reg b, Reg c) { return _mm256_fmadd_ps(a, b, c); }
+	static Reg div(Reg lhs, Reg rhs) { return _mm256_div_ps(lhs, rhs); }
+	static Reg sqrt(Reg value) { return _mm256_sqrt_ps(value); }
+	static Reg flipSign(Reg value, Reg sign) { return _mm256_xor_ps(value, _mm256_and_ps(sign, _mm256_set1_ps(-0.f))); }
+	static Reg load(float const* first) { return _mm256_loadu_ps(first); }
+	static void store(float* first, Reg value) { _mm256_storeu_ps(first, value); }
+
+	static Reg gather(float const* first, size_t stride)
+	{
+		__m256i offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(int(stride)));
+		return _mm256_i32gather_ps(first, offsets, 1);
+	}
+
+	static Reg gather(float const* base, int32_t const* offsets)
+	{
+		return _mm256_i32gather_ps(base, _mm256_loadu_si256(reinterpret_cast<__m256i const*>(offsets)), 4);
+	}
+
+	static void scatter(float* first, size_t stride, Reg value)
+	{
+		alignas(32) float lanes[WIDTH];
+		_mm256_store_ps(lanes, value);
+		for (size_t lane = 0; lane < WIDTH; lane++)
+		{
+			*advance(first, lane * stride) = lanes[lane];
+		}
+	}
+};
+
+// Two columns of the product per register: each half holds a column of lhs weighted by an element of a column of rhs
+void multiplyMat4s(Mat4 const* lhs, Mat4 const* rhs, Mat4* result, size_t count)
+{
+	for (size_t index = 0; index < count; index++)
+	{
+		float const* l = reinterpret_cast<float const*>(lhs + index);
+		float const* r = reinterpret_cast<float const*>(rhs + index);
+
+		__m256 columns[4] = { _mm256_broadcast_ps(reinterpret_cast<__m128 const*>(l)),
+							  _mm256_broadcast_ps(reinterpret_cast<__m128 const*>(l + 4)),
+							  _mm256_broadcast_ps(reinterpret_cast<__m128 const*>(l + 8)),
+							  _mm256_broadcast_ps(reinterpret_cast<__m128 const*>(l + 12)) };
+		__m256 rhsPairs[2] = { _mm256_loadu_ps(r), _mm256_loadu_ps(r + 8) };
+
+		for (size_t pair = 0; pair < 2; pair++)
+		{
+			__m256 product = _mm256_mul_ps(columns[0], _mm256_permute_ps(rhsPairs[pair], 0x00));
+			product = _mm256_fmadd_ps(columns[1], _mm256_permute_ps(rhsPairs[pair], 0x55), product);
+			product = _mm256_fmadd_ps(columns[2], _mm256_permute_ps(rhsPairs[pair], 0xAA), product);
+			product = _mm256_fmadd_ps(columns[3], _mm256_permute_ps(rhsPairs[pair], 0xFF), product);
+			_mm256_storeu_ps(reinterpret_cast<float*>(result + index) + 8 * pair, product);
+		}
+	}
+}
+
+void toHalfFloats(float const* values, uint16_t* result, size_t count)
+{
+	size_t index = 0;
+	for (; index + 8 <= count; index += 8)
+	{
+		__m128i halves = _mm256_cvtps_ph(_mm256_loadu_ps(values + index), _MM_FROUND_TO_NEAREST_INT);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(result + index), halves);
+	}
+	for (; index < count; index++)
+	{
+		result[index] = toHalfFloat(values[index]);
+	}
+}
+
+constexpr BatchKernels makeAVX2Kernels(void)
+{
+	BatchKernels kernels = makeBatchKernels<AVX2Backend>();
+	kernels.m_multiplyMat4 = &multiplyMat4s;
+	kernels.m_toHalfFloats = &toHalfFloats;
+	return kernels;
+}
+
+constexpr BatchKernels g_AVX2Kernels = makeAVX2Kernels();
+} // namespace
+
+BatchKernels const* getAVX2BatchKernels(void)
+{
+	return &g_AVX2Kernels;
+}
+#else
+BatchKernels const* getAVX2BatchKernels(void)
+{
+	return nullptr;
+}
+#endif
+} // namespace BatchDetail
+} // namespace LibMath
@@ -0,0 +1,888 @@
+#ifndef __LIBMATH__BATCH_KERNELS_HPP__
+#define __LIBMATH__BATCH_KERNELS_HPP__
+
+// Batch kernels written once against a SIMD backend:
+// struct Backend
+// {
+//     using Reg = ...;                                      // WIDTH floats
+//     static constexpr size_t WIDTH;
+//     static Reg  set1(float);
+//     static Reg  add(Reg, Reg), sub(Reg, Reg), mul(Reg, Reg);
+//     static Reg  mulAdd(Reg a, Reg b, Reg c);              // a * b + c
+//     static Reg  div(Reg, Reg), sqrt(Reg);
+//     static Reg  flipSign(Reg value, Reg sign);            // value negated in the lanes where sign is negative
+//     static Reg  load(float const*);                       // WIDTH contiguous floats, unaligned
+//     static void store(float*, Reg);
+//     static Reg  gather(float const* first, size_t stride); // WIDTH floats, stride bytes apart
+//     static Reg  gather(float const* base, int32_t const* offsets); // base[offsets[lane]], WIDTH offsets in floats
+//     static void scatter(float* first, size_t stride, Reg);
+// };
+// Each backend instantiates the kernels in its own translation unit, built with the matching instruction set.
+// The templates have internal linkage so the linker can not swap the scalar remainder loop of a translation unit
+// built for AVX2 into the SSE or scalar ones.
+
+#include "LibMath/Batch.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace LibMath
+{
+namespace BatchDetail
+{
+struct BatchKernels
+{
+	void (*m_multiply)(Quaternion const*, Quaternion const*, Quaternion*, size_t);
+	void (*m_rotate)(Quaternion const*, Vec3 const*, Vec3*, size_t);
+	void (*m_compose)(ConstRigidTransforms const&, ConstRigidTransforms const&, RigidTransforms const&, size_t);
+	void (*m_invert)(ConstRigidTransforms const&, RigidTransforms const&, size_t);
+	void (*m_toAffineMat4)(ConstRigidTransforms const&, Mat4*, size_t);
+	void (*m_toDualQuaternion)(ConstRigidTransforms const&, DualQuaternion*, size_t);
+	void (*m_toAffineMat3x4)(ConstRigidTransforms const&, AffineMat3x4*, size_t);
+	void (*m_toHalfFloats)(float const*, uint16_t*, size_t);
+	void (*m_inverse)(Mat4 const*, Mat4*, size_t);
+	void (*m_affineInverse)(Mat4 const*, Mat4*, size_t);
+	void (*m_rigidInverse)(Mat4 const*, Mat4*, size_t);
+	void (*m_multiplyMat4)(Mat4 const*, Mat4 const*, Mat4*, size_t);
+	void (*m_skin)(ConstSkinningVertices const&, Mat4 const*, SkinnedVertices const&, size_t);
+	void (*m_skinDualQuaternion)(ConstSkinningVertices const&, DualQuaternion const*, SkinnedVertices const&, size_t);
+};
+
+// Kernel tables of the backends built in this binary, nullptr when an instruction set is not available.
+// A backend may replace a kernel by one better suited to its instruction set after makeBatchKernels.
+BatchKernels const* getScalarBatchKernels(void);
+BatchKernels const* getSSEBatchKernels(void);
+BatchKernels const* getAVX2BatchKernels(void);
+
+namespace
+{
+struct ScalarBackend
+{
+	using Reg = float;
+	static constexpr size_t WIDTH = 1;
+
+	static Reg set1(float value) { return value; }
+	static Reg add(Reg lhs, Reg rhs) { return lhs + rhs; }
+	static Reg sub(Reg lhs, Reg rhs) { return lhs - rhs; }
+	static Reg mul(Reg lhs, Reg rhs) { return lhs * rhs; }
+	static Reg mulAdd(Reg a, Reg b, Reg c) { return a * b + c; }
+	static Reg div(Reg lhs, Reg rhs) { return lhs / rhs; }
+	static Reg sqrt(Reg value) { return std::sqrt(value); }
+	static Reg flipSign(Reg value, Reg sign) { return std::signbit(sign) ? -value : value; }
+	static Reg load(float const* first) { return *first; }
+	static void store(float* first, Reg value) { *first = value; }
+	static Reg gather(float const* first, size_t) { return *first; }
+	static Reg gather(float const* base, int32_t const* offsets) { return base[*offsets]; }
+	static void scatter(float* first, size_t, Reg value) { *first = value; }
+};
+
+template<class T>
+T* advance(T* pointer, size_t bytes)
+{
+	using Byte = std::conditional_t<std::is_const_v<T>, char const, char>;
+	return reinterpret_cast<T*>(reinterpret_cast<Byte*>(pointer) + bytes);
+}
+
+template<class B>
+struct QuaternionLanes
+{
+	typename B::Reg m_a, m_b, m_c, m_d;
+};
+
+template<class B>
+struct Vec3Lanes
+{
+	typename B::Reg m_x, m_y, m_z;
+};
+
+template<class B>
+QuaternionLanes<B> loadQuaternions(Quaternion const* first, size_t stride)
+{
+	return { B::gather(&first->m_a, stride), B::gather(&first->m_b, stride), B::gather(&first->m_c, stride),
+			 B::gather(&first->m_d, stride) };
+}
+
+template<class B>
+void storeQuaternions(Quaternion* first, size_t stride, QuaternionLanes<B> const& lanes)
+{
+	B::scatter(&first->m_a, stride, lanes.m_a);
+	B::scatter(&first->m_b, stride, lanes.m_b);
+	B::scatter(&first->m_c, stride, lanes.m_c);
+	B::scatter(&first->m_d, stride, lanes.m_d);
+}
+
+template<class B>
+Vec3Lanes<B> loadVec3s(Vec3 const* first, size_t stride)
+{
+	return { B::gather(&first->m_x, stride), B::gather(&first->m_y, stride), B::gather(&first->m_z, stride) };
+}
+
+template<class B>
+void storeVec3s(Vec3* first, size_t stride, Vec3Lanes<B> const& lanes)
+{
+	B::scatter(&first->m_x, stride, lanes.m_x);
+	B::scatter(&first->m_y, stride, lanes.m_y);
+	B::scatter(&first->m_z, stride, lanes.m_z);
+}
+
+template<class B>
+QuaternionLanes<B> multiplyLanes(QuaternionLanes<B> const& l, QuaternionLanes<B> const& r)
+{
+	return {
+		B::sub(B::mul(l.m_a, r.m_a), B::mulAdd(l.m_b, r.m_b, B::mulAdd(l.m_c, r.m_c, B::mul(l.m_d, r.m_d)))),
+		B::mulAdd(l.m_a, r.m_b, B::mulAdd(l.m_b, r.m_a, B::sub(B::mul(l.m_c, r.m_d), B::mul(l.m_d, r.m_c)))),
+		B::mulAdd(l.m_a, r.m_c, B::mulAdd(l.m_c, r.m_a, B::sub(B::mul(l.m_d, r.m_b), B::mul(l.m_b, r.m_d)))),
+		B::mulAdd(l.m_a, r.m_d, B::mulAdd(l.m_d, r.m_a, B::sub(B::mul(l.m_b, r.m_c), B::mul(l.m_c, r.m_b)))),
+	};
+}
+
+// p' = p + w * t + v x t, with t = 2 * (v x p) and v the vector part of the unit quaternion
+template<class B>
+Vec3Lanes<B> rotateLanes(QuaternionLanes<B> const& q, Vec3Lanes<B> const& p)
+{
+	typename B::Reg two = B::set1(2.f);
+	typename B::Reg tx = B::mul(two, B::sub(B::mul(q.m_c, p.m_z), B::mul(q.m_d, p.m_y)));
+	typename B::Reg ty = B::mul(two, B::sub(B::mul(q.m_d, p.m_x), B::mul(q.m_b, p.m_z)));
+	typename B::Reg tz = B::mul(two, B::sub(B::mul(q.m_b, p.m_y), B::mul(q.m_c, p.m_x)));
+
+	return {
+		B::sub(B::mulAdd(q.m_c, tz, B::mulAdd(q.m_a, tx, p.m_x)), B::mul(q.m_d, ty)),
+		B::sub(B::mulAdd(q.m_d, tx, B::mulAdd(q.m_a, ty, p.m_y)), B::mul(q.m_b, tz)),
+		B::sub(B::mulAdd(q.m_b, ty, B::mulAdd(q.m_a, tz, p.m_z)), B::mul(q.m_c, tx)),
+	};
+}
+
+template<class B>
+void multiplyBlock(Quaternion const* lhs, Quaternion const* rhs, Quaternion* result)
+{
+	QuaternionLanes<B> product =
+		multiplyLanes<B>(loadQuaternions<B>(lhs, sizeof(Quaternion)), loadQuaternions<B>(rhs, sizeof(Quaternion)));
+	storeQuaternions<B>(result, sizeof(Quaternion), product);
+}
+
+template<class B>
+void rotateBlock(Quaternion const* rotations, Vec3 const* points, Vec3* result)
+{
+	Vec3Lanes<B> rotated = rotateLanes<B>(loadQuaternions<B>(rotations, sizeof(Quaternion)), loadVec3s<B>(points, sizeof(Vec3)));
+	storeVec3s<B>(result, sizeof(Vec3), rotated);
+}
+
+template<class B>
+void composeBlock(ConstRigidTransforms const& child, ConstRigidTransforms const& parent, RigidTransforms const& result, size_t index)
+{
+	QuaternionLanes<B> parentRotation = loadQuaternions<B>(advance(parent.m_rotations, index * parent.m_stride), parent.m_stride);
+	QuaternionLanes<B> childRotation = loadQuaternions<B>(advance(child.m_rotations, index * child.m_stride), child.m_stride);
+	Vec3Lanes<B>	   parentPosition = loadVec3s<B>(advance(parent.m_positions, index * parent.m_stride), parent.m_stride);
+	Vec3Lanes<B>	   childPosition = loadVec3s<B>(advance(child.m_positions, index * child.m_stride), child.m_stride);
+
+	Vec3Lanes<B> position = rotateLanes<B>(parentRotation, childPosition);
+	position = { B::add(position.m_x, parentPosition.m_x), B::add(position.m_y, parentPosition.m_y),
+				 B::add(position.m_z, parentPosition.m_z) };
+
+	storeVec3s<B>(advance(result.m_positions, index * result.m_stride), result.m_stride, position);
+	storeQuaternions<B>(
+		advance(result.m_rotations, index * result.m_stride), result.m_stride, multiplyLanes<B>(parentRotation, childRotation));
+}
+
+template<class B>
+void invertBlock(ConstRigidTransforms const& transforms, RigidTransforms const& result, size_t index)
+{
+	QuaternionLanes<B> rotation = loadQuaternions<B>(advance(transforms.m_rotations, index * transforms.m_stride), transforms.m_stride);
+	Vec3Lanes<B>	   position = loadVec3s<B>(advance(transforms.m_positions, index * transforms.m_stride), transforms.m_stride);
+
+	typename B::Reg zero = B::set1(0.f);
+	QuaternionLanes<B> conjugate = { rotation.m_a, B::sub(zero, rotation.m_b), B::sub(zero, rotation.m_c),
+									 B::sub(zero, rotation.m_d) };
+
+	Vec3Lanes<B> rotated = rotateLanes<B>(conjugate, position);
+	rotated = { B::sub(zero, rotated.m_x), B::sub(zero, rotated.m_y), B::sub(zero, rotated.m_z) };
+
+	storeVec3s<B>(advance(result.m_positions, index * result.m_stride), result.m_stride, rotated);
+	storeQuaternions<B>(advance(result.m_rotations, index * result.m_stride), result.m_stride, conjugate);
+}
+
+// Same terms as toAffineMat4, column after column, with the last row of each column
+template<class B>
+void affineColumns(ConstRigidTransforms const& transforms, size_t index, typename B::Reg (&columns)[16])
+{
+	QuaternionLanes<B> q = loadQuaternions<B>(advance(transforms.m_rotations, index * transforms.m_stride), transforms.m_stride);
+	Vec3Lanes<B>	   p = loadVec3s<B>(advance(transforms.m_positions, index * transforms.m_stride), transforms.m_stride);
+
+	typename B::Reg one = B::set1(1.f);
+	typename B::Reg scale =
+		B::div(B::set1(2.f), B::mulAdd(q.m_a, q.m_a, B::mulAdd(q.m_b, q.m_b, B::mulAdd(q.m_c, q.m_c, B::mul(q.m_d, q.m_d)))));
+
+	typename B::Reg sb = B::mul(q.m_b, scale);
+	typename B::Reg sc = B::mul(q.m_c, scale);
+	typename B::Reg sd = B::mul(q.m_d, scale);
+
+	typename B::Reg bb = B::mul(q.m_b, sb), cc = B::mul(q.m_c, sc), dd = B::mul(q.m_d, sd);
+	typename B::Reg ab = B::mul(q.m_a, sb), ac = B::mul(q.m_a, sc), ad = B::mul(q.m_a, sd);
+	typename B::Reg bc = B::mul(q.m_b, sc), bd = B::mul(q.m_b, sd), cd = B::mul(q.m_c, sd);
+
+	typename B::Reg const terms[16] = {
+		B::sub(B::sub(one, cc), dd), B::add(bc, ad), B::sub(bd, ac), B::set1(0.f),
+		B::sub(bc, ad), B::sub(B::sub(one, bb), dd), B::add(cd, ab), B::set1(0.f),
+		B::add(bd, ac), B::sub(cd, ab), B::sub(B::sub(one, bb), cc), B::set1(0.f),
+		p.m_x, p.m_y, p.m_z, one,
+	};
+	for (size_t element = 0; element < 16; element++)
+	{
+		columns[element] = terms[element];
+	}
+}
+
+template<class B>
+void toAffineMat4Block(ConstRigidTransforms const& transforms, Mat4* result, size_t index)
+{
+	static_assert(sizeof(Mat4) == 16 * sizeof(float), "Mat4 is expected to be 16 packed floats");
+
+	typename B::Reg columns[16];
+	affineColumns<B>(transforms, index, columns);
+
+	// Mat4 members are not touched so no inline Mat4 code gets built with the instruction set of this backend
+	float* first = reinterpret_cast<float*>(result + index);
+	for (size_t element = 0; element < 16; element++)
+	{
+		B::scatter(first + element, sizeof(Mat4), columns[element]);
+	}
+}
+
+// The columns of toAffineMat4 written row after row, without the last row
+template<class B>
+void toAffineMat3x4Block(ConstRigidTransforms const& transforms, AffineMat3x4* result, size_t index)
+{
+	static_assert(sizeof(AffineMat3x4) == 12 * sizeof(float), "AffineMat3x4 is expected to be 12 packed floats");
+
+	typename B::Reg columns[16];
+	affineColumns<B>(transforms, index, columns);
+
+	float* first = result[index].m_rows[0];
+	for (size_t row = 0; row < 3; row++)
+	{
+		for (size_t column = 0; column < 4; column++)
+		{
+			B::scatter(first + row * 4 + column, sizeof(AffineMat3x4), columns[column * 4 + row]);
+		}
+	}
+}
+
+// dual = (0, translation / 2) * rotation
+template<class B>
+void toDualQuaternionBlock(ConstRigidTransforms const& transforms, DualQuaternion* result, size_t index)
+{
+	static_assert(sizeof(DualQuaternion) == 8 * sizeof(float), "DualQuaternion is expected to be 8 packed floats");
+
+	QuaternionLanes<B> q = loadQuaternions<B>(advance(transforms.m_rotations, index * transforms.m_stride), transforms.m_stride);
+	Vec3Lanes<B>	   p = loadVec3s<B>(advance(transforms.m_positions, index * transforms.m_stride), transforms.m_stride);
+
+	typename B::Reg	   half = B::set1(0.5f);
+	QuaternionLanes<B> translation = { B::set1(0.f), B::mul(p.m_x, half), B::mul(p.m_y, half), B::mul(p.m_z, half) };
+
+	storeQuaternions<B>(&result[index].m_real, sizeof(DualQuaternion), q);
+	storeQuaternions<B>(&result[index].m_dual, sizeof(DualQuaternion), multiplyLanes<B>(translation, q));
+}
+
+// Elements of Mat4s, column after column. Mat4 members are not touched so no inline Mat4 code gets built with the
+// instruction set of the backend.
+template<class B>
+struct Mat4Lanes
+{
+	typename B::Reg m_m[4][4];
+};
+
+template<class B>
+Mat4Lanes<B> loadMat4s(Mat4 const* first)
+{
+	static_assert(sizeof(Mat4) == 16 * sizeof(float), "Mat4 is expected to be 16 packed floats");
+
+	float const* elements = reinterpret_cast<float const*>(first);
+	Mat4Lanes<B> lanes;
+	for (size_t column = 0; column < 4; column++)
+	{
+		for (size_t row = 0; row < 4; row++)
+		{
+			lanes.m_m[column][row] = B::gather(elements + column * 4 + row, sizeof(Mat4));
+		}
+	}
+	return lanes;
+}
+
+template<class B>
+void storeMat4s(Mat4* first, Mat4Lanes<B> const& lanes)
+{
+	float* elements = reinterpret_cast<float*>(first);
+	for (size_t column = 0; column < 4; column++)
+	{
+		for (size_t row = 0; row < 4; row++)
+		{
+			B::scatter(elements + column * 4 + row, sizeof(Mat4), lanes.m_m[column][row]);
+		}
+	}
+}
+
+// a * b - c * d
+template<class B>
+typename B::Reg differenceOfProducts(typename B::Reg a, typename B::Reg b, typename B::Reg c, typename B::Reg d)
+{
+	return B::sub(B::mul(a, b), B::mul(c, d));
+}
+
+// (a * x - b * y + c * z) * scale
+template<class B>
+typename B::Reg cofactor(
+	typename B::Reg a, typename B::Reg x, typename B::Reg b, typename B::Reg y, typename B::Reg c, typename B::Reg z,
+	typename B::Reg scale)
+{
+	return B::mul(B::mulAdd(c, z, B::sub(B::mul(a, x), B::mul(b, y))), scale);
+}
+
+// Same expansion as Mat4::GetInverse
+template<class B>
+Mat4Lanes<B> inverseLanes(Mat4Lanes<B> const& lanes)
+{
+	auto const& m = lanes.m_m;
+
+	typename B::Reg s0 = differenceOfProducts<B>(m[0][0], m[1][1], m[1][0], m[0][1]);
+	typename B::Reg s1 = differenceOfProducts<B>(m[0][0], m[1][2], m[1][0], m[0][2]);
+	typename B::Reg s2 = differenceOfProducts<B>(m[0][0], m[1][3], m[1][0], m[0][3]);
+	typename B::Reg s3 = differenceOfProducts<B>(m[0][1], m[1][2], m[1][1], m[0][2]);
+	typename B::Reg s4 = differenceOfProducts<B>(m[0][1], m[1][3], m[1][1], m[0][3]);
+	typename B::Reg s5 = differenceOfProducts<B>(m[0][2], m[1][3], m[1][2], m[0][3]);
+
+	typename B::Reg c5 = differenceOfProducts<B>(m[2][2], m[3][3], m[3][2], m[2][3]);
+	typename B::Reg c4 = differenceOfProducts<B>(m[2][1], m[3][3], m[3][1], m[2][3]);
+	typename B::Reg c3 = differenceOfProducts<B>(m[2][1], m[3][2], m[3][1], m[2][2]);
+	typename B::Reg c2 = differenceOfProducts<B>(m[2][0], m[3][3], m[3][0], m[2][3]);
+	typename B::Reg c1 = differenceOfProducts<B>(m[2][0], m[3][2], m[3][0], m[2][2]);
+	typename B::Reg c0 = differenceOfProducts<B>(m[2][0], m[3][1], m[3][0], m[2][1]);
+
+	typename B::Reg determinant = B::mulAdd(s2, c3, differenceOfProducts<B>(s0, c5, s1, c4));
+	determinant = B::mulAdd(s5, c0, B::sub(B::mulAdd(s3, c2, determinant), B::mul(s4, c1)));
+	typename B::Reg inverse = B::div(B::set1(1.f), determinant);
+	typename B::Reg negative = B::sub(B::set1(0.f), inverse);
+
+	Mat4Lanes<B> result;
+	auto&		 r = result.m_m;
+
+	r[0][0] = cofactor<B>(m[1][1], c5, m[1][2], c4, m[1][3], c3, inverse);
+	r[0][1] = cofactor<B>(m[0][1], c5, m[0][2], c4, m[0][3], c3, negative);
+	r[0][2] = cofactor<B>(m[3][1], s5, m[3][2], s4, m[3][3], s3, inverse);
+	r[0][3] = cofactor<B>(m[2][1], s5, m[2][2], s4, m[2][3], s3, negative);
+
+	r[1][0] = cofactor<B>(m[1][0], c5, m[1][2], c2, m[1][3], c1, negative);
+	r[1][1] = cofactor<B>(m[0][0], c5, m[0][2], c2, m[0][3], c1, inverse);
+	r[1][2] = cofactor<B>(m[3][0], s5, m[3][2], s2, m[3][3], s1, negative);
+	r[1][3] = cofactor<B>(m[2][0], s5, m[2][2], s2, m[2][3], s1, inverse);
+
+	r[2][0] = cofactor<B>(m[1][0], c4, m[1][1], c2, m[1][3], c0, inverse);
+	r[2][1] = cofactor<B>(m[0][0], c4, m[0][1], c2, m[0][3], c0, negative);
+	r[2][2] = cofactor<B>(m[3][0], s4, m[3][1], s2, m[3][3], s0, inverse);
+	r[2][3] = cofactor<B>(m[2][0], s4, m[2][1], s2, m[2][3], s0, negative);
+
+	r[3][0] = cofactor<B>(m[1][0], c3, m[1][1], c1, m[1][2], c0, negative);
+	r[3][1] = cofactor<B>(m[0][0], c3, m[0][1], c1, m[0][2], c0, inverse);
+	r[3][2] = cofactor<B>(m[3][0], s3, m[3][1], s1, m[3][2], s0, negative);
+	r[3][3] = cofactor<B>(m[2][0], s3, m[2][1], s1, m[2][2], s0, inverse);
+
+	return result;
+}
+
+// Inverse of the 3x3 part given the rows of its inverse, and translation rotated back
+template<class B>
+Mat4Lanes<B> affineInverseFromRows(Mat4Lanes<B> const& lanes, typename B::Reg const (&rows)[3][3])
+{
+	auto const&		m = lanes.m_m;
+	typename B::Reg zero = B::set1(0.f);
+
+	Mat4Lanes<B> result;
+	for (size_t row = 0; row < 3; row++)
+	{
+		for (size_t column = 0; column < 3; column++)
+		{
+			result.m_m[column][row] = rows[row][column];
+		}
+		result.m_m[row][3] = zero;
+
+		typename B::Reg translation =
+			B::mulAdd(rows[row][2], m[3][2], B::mulAdd(rows[row][1], m[3][1], B::mul(rows[row][0], m[3][0])));
+		result.m_m[3][row] = B::sub(zero, translation);
+	}
+	result.m_m[3][3] = B::set1(1.f);
+
+	return result;
+}
+
+// Same as Mat4::GetAffineInverse
+template<class B>
+Mat4Lanes<B> affineInverseLanes(Mat4Lanes<B> const& lanes)
+{
+	auto const& m = lanes.m_m;
+
+	typename B::Reg rows[3][3] = {
+		{ differenceOfProducts<B>(m[1][1], m[2][2], m[1][2], m[2][1]), differenceOfProducts<B>(m[1][2], m[2][0], m[1][0], m[2][2]),
+		  differenceOfProducts<B>(m[1][0], m[2][1], m[1][1], m[2][0]) },
+		{ differenceOfProducts<B>(m[2][1], m[0][2], m[2][2], m[0][1]), differenceOfProducts<B>(m[2][2], m[0][0], m[2][0], m[0][2]),
+		  differenceOfProducts<B>(m[2][0], m[0][1], m[2][1], m[0][0]) },
+		{ differenceOfProducts<B>(m[0][1], m[1][2], m[0][2], m[1][1]), differenceOfProducts<B>(m[0][2], m[1][0], m[0][0], m[1][2]),
+		  differenceOfProducts<B>(m[0][0], m[1][1], m[0][1], m[1][0]) },
+	};
+
+	typename B::Reg determinant = B::mulAdd(m[0][2], rows[0][2], B::mulAdd(m[0][1], rows[0][1], B::mul(m[0][0], rows[0][0])));
+	typename B::Reg inverse = B::div(B::set1(1.f), determinant);
+	for (auto& row : rows)
+	{
+		for (typename B::Reg& element : row)
+		{
+			element = B::mul(element, inverse);
+		}
+	}
+
+	return affineInverseFromRows<B>(lanes, rows);
+}
+
+// Same as Mat4::GetRigidInverse
+template<class B>
+Mat4Lanes<B> rigidInverseLanes(Mat4Lanes<B> const& lanes)
+{
+	auto const& m = lanes.m_m;
+
+	typename B::Reg const rows[3][3] = {
+		{ m[0][0], m[0][1], m[0][2] },
+		{ m[1][0], m[1][1], m[1][2] },
+		{ m[2][0], m[2][1], m[2][2] },
+	};
+
+	return affineInverseFromRows<B>(lanes, rows);
+}
+
+// Elements of the product are written in the lanes of the result, lhs and rhs are left untouched
+template<class B>
+void multiplyMat4Block(Mat4 const* lhs, Mat4 const* rhs, Mat4* result)
+{
+	Mat4Lanes<B> l = loadMat4s<B>(lhs);
+	Mat4Lanes<B> r = loadMat4s<B>(rhs);
+	Mat4Lanes<B> product;
+	for (size_t column = 0; column < 4; column++)
+	{
+		for (size_t row = 0; row < 4; row++)
+		{
+			typename B::Reg element = B::mul(l.m_m[0][row], r.m_m[column][0]);
+			element = B::mulAdd(l.m_m[1][row], r.m_m[column][1], element);
+			element = B::mulAdd(l.m_m[2][row], r.m_m[column][2], element);
+			product.m_m[column][row] = B::mulAdd(l.m_m[3][row], r.m_m[column][3], element);
+		}
+	}
+	storeMat4s<B>(result, product);
+}
+
+template<class B>
+void multiplyMat4Kernel(Mat4 const* lhs, Mat4 const* rhs, Mat4* result, size_t count)
+{
+	size_t index = 0;
+	for (; index + B::WIDTH <= count; index += B::WIDTH)
+	{
+		multiplyMat4Block<B>(lhs + index, rhs + index, result + index);
+	}
+	for (; index < count; index++)
+	{
+		multiplyMat4Block<ScalarBackend>(lhs + index, rhs + index, result + index);
+	}
+}
+
+template<class B>
+void inverseBlock(Mat4 const* matrices, Mat4* result)
+{
+	storeMat4s<B>(result, inverseLanes<B>(loadMat4s<B>(matrices)));
+}
+
+template<class B>
+void affineInverseBlock(Mat4 const* matrices, Mat4* result)
+{
+	storeMat4s<B>(result, affineInverseLanes<B>(loadMat4s<B>(matrices)));
+}
+
+template<class B>
+void rigidInverseBlock(Mat4 const* matrices, Mat4* result)
+{
+	storeMat4s<B>(result, rigidInverseLanes<B>(loadMat4s<B>(matrices)));
+}
+
+// Full blocks with the backend, the remainder one element at a time
+template<class B>
+void multiplyKernel(Quaternion const* lhs, Quaternion const* rhs, Quaternion* result, size_t count)
+{
+	size_t index = 0;
+	for (; index + B::WIDTH <= count; index += B::WIDTH)
+	{
+		multiplyBlock<B>(lhs + index, rhs + index, result + index);
+	}
+	for (; index < count; index++)
+	{
+		multiplyBlock<ScalarBackend>(lhs + index, rhs + index, result + index);
+	}
+}
+
+template<class B>
+void rotateKernel(Quaternion const* rotations, Vec3 const* points, Vec3* result, size_t count)
+{
+	size_t index = 0;
+	for (; index + B::WIDTH <= count; index += B::WIDTH)
+	{
+		rotateBlock<B>(rotations + index, points + index, result + index);
+	}
+	for (; index < count; index++)
+	{
+		rotateBlock<ScalarBackend>(rotations + index, points + index, result + index);
+	}
+}
+
+template<class B>
+void composeKernel(ConstRigidTransforms const& child, ConstRigidTransforms const& parent, RigidTransforms const& result, size_t count)
+{
+	size_t index = 0;
+	for (; index + B::WIDTH <= count; index += B::WIDTH)
+	{
+		composeBlock<B>(child, parent, result, index);
+	}
+	for (; index < count; index++)
+	{
+		composeBlock<ScalarBackend>(child, parent, result, index);
+	}
+}
+
+template<class B>
+void invertKernel(ConstRigidTransforms const& transforms, RigidTransforms const& result, size_t count)
+{
+	size_t index = 0;
+	for (; index + B::WIDTH <= count; index += B::WIDTH)
+	{
+		invertBlock<B>(transforms, result, index);
+	}
+	for (; index < count; index++)
+	{
+		invertBlock<ScalarBackend>(transforms, result, index);
+	}
+}
+
+template<class B>
+void toAffineMat4Kernel(ConstRigidTransforms const& transforms, Mat4* result, size_t count)
+{
+	size_t index = 0;
+	for (; index + B::WIDTH <= count; index += B::WIDTH)
+	{
+		toAffineMat4Block<B>(transforms, result, index);
+	}
+	for (; index < count; index++)
+	{
+		toAffineMat4Block<ScalarBackend>(transforms, result, index);
+	}
+}
+
+template<class B>
+void toAffineMat3x4Kernel(ConstRigidTransforms const& transforms, AffineMat3x4* result, size_t count)
+{
+	size_t index = 0;
+	for (; index + B::WIDTH <= count; index += B::WIDTH)
+	{
+		toAffineMat3x4Block<B>(transforms, result, index);
+	}
+	for (; index < count; index++)
+	{
+		toAffineMat3x4Block<ScalarBackend>(transforms, result, index);
+	}
+}
+
+template<class B>
+void toDualQuaternionKernel(ConstRigidTransforms const& transforms, DualQuaternion* result, size_t count)
+{
+	size_t index = 0;
+	for (; index + B::WIDTH <= count; index += B::WIDTH)
+	{
+		toDualQuaternionBlock<B>(transforms, result, index);
+	}
+	for (; index < count; index++)
+	{
+		toDualQuaternionBlock<ScalarBackend>(transforms, result, index);
+	}
+}
+
+// Matrices one block at a time, BLOCK being one of the matrix block functions above
+template<class B, void (*BLOCK)(Mat4 const*, Mat4*), void (*REMAINDER)(Mat4 const*, Mat4*)>
+void matrixKernel(Mat4 const* matrices, Mat4* result, size_t count)
+{
+	size_t index = 0;
+	for (; index + B::WIDTH <= count; index += B::WIDTH)
+	{
+		BLOCK(matrices + index, result + index);
+	}
+	for (; index < count; index++)
+	{
+		REMAINDER(matrices + index, result + index);
+	}
+}
+
+// Weighted sum of the palette matrices of each vertex, then the same transform as skinning.vs.
+// Influences whose weight is zero for the whole block skip their gathers, most vertices only have one or two.
+template<class B>
+void skinBlock(ConstSkinningVertices const& vertices, Mat4 const* palette, SkinnedVertices const& result, size_t index)
+{
+	static_assert(sizeof(Mat4) == 16 * sizeof(float), "Mat4 is expected to be 16 packed floats");
+
+	// Columns 0 to 2 then the translation, without the last row of the affine matrices
+	constexpr int32_t elements[12] = { 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14 };
+
+	float const*	palettes = reinterpret_cast<float const*>(palette);
+	typename B::Reg blended[12];
+	for (typename B::Reg& element : blended)
+	{
+		element = B::set1(0.f);
+	}
+
+	for (size_t influence = 0; influence < 4; influence++)
+	{
+		float const* weights = vertices.m_boneWeights[influence] + index;
+
+		bool isUsed = false;
+		for (size_t lane = 0; lane < B::WIDTH; lane++)
+		{
+			isUsed |= weights[lane] != 0.f;
+		}
+		if (!isUsed)
+		{
+			continue;
+		}
+
+		int32_t offsets[B::WIDTH];
+		for (size_t lane = 0; lane < B::WIDTH; lane++)
+		{
+			offsets[lane] = vertices.m_boneIndices[influence][index + lane] * 16;
+		}
+
+		typename B::Reg weight = B::load(weights);
+		for (size_t element = 0; element < 12; element++)
+		{
+			blended[element] = B::mulAdd(weight, B::gather(palettes + elements[element], offsets), blended[element]);
+		}
+	}
+
+	typename B::Reg px = B::load(vertices.m_positions[0] + index);
+	typename B::Reg py = B::load(vertices.m_positions[1] + index);
+	typename B::Reg pz = B::load(vertices.m_positions[2] + index);
+	typename B::Reg nx = B::load(vertices.m_normals[0] + index);
+	typename B::Reg ny = B::load(vertices.m_normals[1] + index);
+	typename B::Reg nz = B::load(vertices.m_normals[2] + index);
+
+	typename B::Reg normal[3];
+	for (size_t row = 0; row < 3; row++)
+	{
+		typename B::Reg position =
+			B::mulAdd(blended[row], px, B::mulAdd(blended[3 + row], py, B::mulAdd(blended[6 + row], pz, blended[9 + row])));
+		B::store(result.m_positions[row] + index, position);
+
+		normal[row] = B::mulAdd(blended[row], nx, B::mulAdd(blended[3 + row], ny, B::mul(blended[6 + row], nz)));
+	}
+
+	typename B::Reg inverseLength = B::div(
+		B::set1(1.f), B::sqrt(B::mulAdd(normal[0], normal[0], B::mulAdd(normal[1], normal[1], B::mul(normal[2], normal[2])))));
+	for (size_t row = 0; row < 3; row++)
+	{
+		B::store(result.m_normals[row] + index, B::mul(normal[row], inverseLength));
+	}
+}
+
+// Dual quaternion linear blending. Each influence is flipped to the hemisphere of the first one (q and -q are the same
+// rotation but would cancel out in the sum), then the normalized sum rotates the position and normal and translates
+// the position by 2 * dual * conjugate(real).
+template<class B>
+void skinDualQuaternionBlock(
+	ConstSkinningVertices const& vertices, DualQuaternion const* palette, SkinnedVertices const& result, size_t index)
+{
+	static_assert(sizeof(DualQuaternion) == 8 * sizeof(float), "DualQuaternion is expected to be 8 packed floats");
+
+	float const* palettes = reinterpret_cast<float const*>(palette);
+
+	QuaternionLanes<B> pivot;
+	QuaternionLanes<B> real = { B::set1(0.f), B::set1(0.f), B::set1(0.f), B::set1(0.f) };
+	QuaternionLanes<B> dual = real;
+
+	for (size_t influence = 0; influence < 4; influence++)
+	{
+		float const* weights = vertices.m_boneWeights[influence] + index;
+
+		bool isUsed = influence == 0;
+		for (size_t lane = 0; lane < B::WIDTH; lane++)
+		{
+			isUsed |= weights[lane] != 0.f;
+		}
+		if (!isUsed)
+		{
+			continue;
+		}
+
+		int32_t offsets[B::WIDTH];
+		for (size_t lane = 0; lane < B::WIDTH; lane++)
+		{
+			offsets[lane] = vertices.m_boneIndices[influence][index + lane] * 8;
+		}
+
+		QuaternionLanes<B> influenceReal = { B::gather(palettes, offsets), B::gather(palettes + 1, offsets),
+											 B::gather(palettes + 2, offsets), B::gather(palettes + 3, offsets) };
+		if (influence == 0)
+		{
+			pivot = influenceReal;
+		}
+
+		typename B::Reg alignment = B::mulAdd(
+			influenceReal.m_a, pivot.m_a,
+			B::mulAdd(influenceReal.m_b, pivot.m_b, B::mulAdd(influenceReal.m_c, pivot.m_c, B::mul(influenceReal.m_d, pivot.m_d))));
+		typename B::Reg weight = B::flipSign(B::load(weights), alignment);
+
+		real = { B::mulAdd(weight, influenceReal.m_a, real.m_a), B::mulAdd(weight, influenceReal.m_b, real.m_b),
+				 B::mulAdd(weight, influenceReal.m_c, real.m_c), B::mulAdd(weight, influenceReal.m_d, real.m_d) };
+		dual = { B::mulAdd(weight, B::gather(palettes + 4, offsets), dual.m_a),
+				 B::mulAdd(weight, B::gather(palettes + 5, offsets), dual.m_b),
+				 B::mulAdd(weight, B::gather(palettes + 6, offsets), dual.m_c),
+				 B::mulAdd(weight, B::gather(palettes + 7, offsets), dual.m_d) };
+	}
+
+	typename B::Reg lengthSquared =
+		B::mulAdd(real.m_a, real.m_a, B::mulAdd(real.m_b, real.m_b, B::mulAdd(real.m_c, real.m_c, B::mul(real.m_d, real.m_d))));
+	typename B::Reg inverseLength = B::div(B::set1(1.f), B::sqrt(lengthSquared));
+	real = { B::mul(real.m_a, inverseLength), B::mul(real.m_b, inverseLength), B::mul(real.m_c, inverseLength),
+			 B::mul(real.m_d, inverseLength) };
+	dual = { B::mul(dual.m_a, inverseLength), B::mul(dual.m_b, inverseLength), B::mul(dual.m_c, inverseLength),
+			 B::mul(dual.m_d, inverseLength) };
+
+	// 2 * (w_r * v_d - w_d * v_r + v_r x v_d)
+	typename B::Reg two = B::set1(2.f);
+	typename B::Reg translation[3] = {
+		B::mul(two, B::add(B::sub(B::mul(real.m_a, dual.m_b), B::mul(dual.m_a, real.m_b)),
+						   B::sub(B::mul(real.m_c, dual.m_d), B::mul(real.m_d, dual.m_c)))),
+		B::mul(two, B::add(B::sub(B::mul(real.m_a, dual.m_c), B::mul(dual.m_a, real.m_c)),
+						   B::sub(B::mul(real.m_d, dual.m_b), B::mul(real.m_b, dual.m_d)))),
+		B::mul(two, B::add(B::sub(B::mul(real.m_a, dual.m_d), B::mul(dual.m_a, real.m_d)),
+						   B::sub(B::mul(real.m_b, dual.m_c), B::mul(real.m_c, dual.m_b)))),
+	};
+
+	Vec3Lanes<B> position = rotateLanes<B>(
+		real, { B::load(vertices.m_positions[0] + index), B::load(vertices.m_positions[1] + index),
+				B::load(vertices.m_positions[2] + index) });
+	Vec3Lanes<B> normal = rotateLanes<B>(
+		real, { B::load(vertices.m_normals[0] + index), B::load(vertices.m_normals[1] + index),
+				B::load(vertices.m_normals[2] + index) });
+
+	B::store(result.m_positions[0] + index, B::add(position.m_x, translation[0]));
+	B::store(result.m_positions[1] + index, B::add(position.m_y, translation[1]));
+	B::store(result.m_positions[2] + index, B::add(position.m_z, translation[2]));
+
+	// The stored normals are not exactly unit length, normalized like the matrix path
+	typename B::Reg inverseNormalLength = B::div(
+		B::set1(1.f), B::sqrt(B::mulAdd(normal.m_x, normal.m_x, B::mulAdd(normal.m_y, normal.m_y, B::mul(normal.m_z, normal.m_z)))));
+	B::store(result.m_normals[0] + index, B::mul(normal.m_x, inverseNormalLength));
+	B::store(result.m_normals[1] + index, B::mul(normal.m_y, inverseNormalLength));
+	B::store(result.m_normals[2] + index, B::mul(normal.m_z, inverseNormalLength));
+}
+
+template<class B>
+void skinKernel(ConstSkinningVertices const& vertices, Mat4 const* palette, SkinnedVertices const& result, size_t count)
+{
+	size_t index = 0;
+	for (; index + B::WIDTH <= count; index += B::WIDTH)
+	{
+		skinBlock<B>(vertices, palette, result, index);
+	}
+	for (; index < count; index++)
+	{
+		skinBlock<ScalarBackend>(vertices, palette, result, index);
+	}
+}
+
+template<class B>
+void skinDualQuaternionKernel(
+	ConstSkinningVertices const& vertices, DualQuaternion const* palette, SkinnedVertices const& result, size_t count)
+{
+	size_t index = 0;
+	for (; index + B::WIDTH <= count; index += B::WIDTH)
+	{
+		skinDualQuaternionBlock<B>(vertices, palette, result, index);
+	}
+	for (; index < count; index++)
+	{
+		skinDualQuaternionBlock<ScalarBackend>(vertices, palette, result, index);
+	}
+}
+
+// Round to nearest even: values past the half range become infinities, NaNs stay NaNs and values below 2^-14 become
+// denormals, aligned on the last mantissa bit by a float addition so that it does the rounding
+uint16_t toHalfFloat(float value)
+{
+	static_assert(sizeof(float) == sizeof(uint32_t), "float is expected to be an IEEE 754 single precision float");
+
+	constexpr uint32_t infinity = 255u << 23;
+	constexpr uint32_t halfOverflow = (127u + 16u) << 23;
+	constexpr uint32_t halfNormalMin = 113u << 23;
+	constexpr uint32_t denormalMagic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	uint32_t sign = bits & 0x80000000u;
+	bits ^= sign;
+
+	uint32_t half;
+	if (bits >= halfOverflow)
+	{
+		half = bits > infinity ? 0x7e00u : 0x7c00u;
+	}
+	else if (bits < halfNormalMin)
+	{
+		float magnitude, magic;
+		std::memcpy(&magnitude, &bits, sizeof(bits));
+		std::memcpy(&magic, &denormalMagic, sizeof(magic));
+		magnitude += magic;
+		std::memcpy(&bits, &magnitude, sizeof(bits));
+		half = bits - denormalMagic;
+	}
+	else
+	{
+		uint32_t oddMantissa = (bits >> 13) & 1u;
+		bits += ((15u - 127u) << 23) + 0xfffu + oddMantissa;
+		half = bits >> 13;
+	}
+	return uint16_t(half | (sign >> 16));
+}
+
+// Bit manipulations the float backends can not express, backends with a conversion instruction replace it
+void toHalfFloatsKernel(float const* values, uint16_t* result, size_t count)
+{
+	for (size_t index = 0; index < count; index++)
+	{
+		result[index] = toHalfFloat(values[index]);
+	}
+}
+
+template<class B>
+constexpr BatchKernels makeBatchKernels(void)
+{
+	return { &multiplyKernel<B>,
+			 &rotateKernel<B>,
+			 &composeKernel<B>,
+			 &invertKernel<B>,
+			 &toAffineMat4Kernel<B>,
+			 &toDualQuaternionKernel<B>,
+			 &toAffineMat3x4Kernel<B>,
+			 &toHalfFloatsKernel,
+			 &matrixKernel<B, &inverseBlock<B>, &inverseBlock<ScalarBackend>>,
+			 &matrixKernel<B, &affineInverseBlock<B>, &affineInverseBlock<ScalarBackend>>,
+			 &matrixKernel<B, &rigidInverseBlock<B>, &rigidInverseBlock<ScalarBackend>>,
+			 &multiplyMat4Kernel<B>,
+			 &skinKernel<B>,
+			 &skinDualQuaternionKernel<B> };
+}
+} // namespace
+} // namespace BatchDetail
+} // namespace LibMath
+
+#endif
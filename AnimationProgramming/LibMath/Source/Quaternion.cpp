@@ -1,6 +1,9 @@
 #include "LibMath/Quaternion.h"
 #include "LibMath/Interpolation.h"
 
+#include <cmath>
+#include <stdexcept>
+
 namespace LibMath
 {
 /* OPERATORS */
@@ -122,12 +125,12 @@ Quaternion::operator Vec4(void) const
 
 float Quaternion::magnitude(void) const
 {
-	return std::sqrtf(std::powf(m_a, 2) + std::powf(m_b, 2) + std::powf(m_c, 2) + std::powf(m_d, 2));
+	return std::sqrt(std::pow(m_a, 2) + std::pow(m_b, 2) + std::pow(m_c, 2) + std::pow(m_d, 2));
 }
 
 float Quaternion::magnitudeSquared(void) const
 {
-	return (std::powf(m_a, 2) + std::powf(m_b, 2) + std::powf(m_c, 2));
+	return (std::pow(m_a, 2) + std::pow(m_b, 2) + std::pow(m_c, 2));
 }
 
 Quaternion& Quaternion::toConjugate(void)
@@ -269,33 +272,34 @@ Mat4 toMat4(Quaternion const& quat)
 
 Mat4 toRotationMat4(Quaternion const& quat)
 {
-	Quaternion copy(quat);
+	return toAffineMat4(quat, Vec3::zero());
+}
 
-	if (!copy.isUnitQuaternion())
-	{
-		copy /= copy.magnitude();
-	}
+Mat4 toAffineMat4(Quaternion const& rotation, Vec3 const& translation)
+{
+	// Dividing by the squared magnitude folds the normalization in, no branch nor square root needed
+	float scale = 2.f / (rotation.m_a * rotation.m_a + rotation.m_b * rotation.m_b + rotation.m_c * rotation.m_c +
+						 rotation.m_d * rotation.m_d);
 
-	float aSquared = copy.m_a * copy.m_a;
-	float bSquared = copy.m_b * copy.m_b;
-	float cSquared = copy.m_c * copy.m_c;
-	float dSquared = copy.m_d * copy.m_d;
+	float bb = rotation.m_b * rotation.m_b * scale;
+	float cc = rotation.m_c * rotation.m_c * scale;
+	float dd = rotation.m_d * rotation.m_d * scale;
 
-	float ab = copy.m_a * copy.m_b;
-	float ac = copy.m_a * copy.m_c;
-	float ad = copy.m_a * copy.m_d;
+	float ab = rotation.m_a * rotation.m_b * scale;
+	float ac = rotation.m_a * rotation.m_c * scale;
+	float ad = rotation.m_a * rotation.m_d * scale;
 
-	float bc = copy.m_b * copy.m_c;
-	float bd = copy.m_b * copy.m_d;
+	float bc = rotation.m_b * rotation.m_c * scale;
+	float bd = rotation.m_b * rotation.m_d * scale;
 
-	float cd = copy.m_c * copy.m_d;
+	float cd = rotation.m_c * rotation.m_d * scale;
 
-	Vec4 row1 = { aSquared + bSquared - cSquared - dSquared, 2 * (bc + ad), 2 * (bd - ac), 0.f };
-	Vec4 row2 = { 2 * (bc - ad), aSquared - bSquared + cSquared - dSquared, 2 * (cd + ab), 0.f };
-	Vec4 row3 = { 2 * (bd + ac), 2 * (cd - ab), aSquared - bSquared - cSquared + dSquared, 0.f };
-	Vec4 row4 = { 0.f, 0.f, 0.f, 1.f };
+	Vec4 column1 = { 1.f - cc - dd, bc + ad, bd - ac, 0.f };
+	Vec4 column2 = { bc - ad, 1.f - bb - dd, cd + ab, 0.f };
+	Vec4 column3 = { bd + ac, cd - ab, 1.f - bb - cc, 0.f };
+	Vec4 column4 = { translation.m_x, translation.m_y, translation.m_z, 1.f };
 
-	return Mat4(row1, row2, row3, row4);
+	return Mat4(column1, column2, column3, column4);
 }
 
 /* OUT-OF-CLASS OPERATORS */
@@ -1,6 +1,7 @@
 #include "LibMath/Vector/Vec2.h"
 #include "LibMath/Vector/Vec4.h"
 
+#include <cmath>
 #include <string>
 #include <sstream>
 
@@ -28,7 +29,7 @@ namespace LibMath
 	Radian Vec2::angleFrom(Vec2 const& other) const
 	{
 		float dot = this->dot(other);
-		float radian = std::acosf(dot / (this->magnitude() * other.magnitude()));
+		float radian = std::acos(dot / (this->magnitude() * other.magnitude()));
 
 		return Radian(radian);
 	}
@@ -40,17 +41,17 @@ namespace LibMath
 
 	float Vec2::distanceFrom(Vec2 const& other) const
 	{
-		return std::sqrtf(
-			std::powf(other.m_x - this->m_x, 2) +
-			std::powf(other.m_y - this->m_y, 2)
+		return std::sqrt(
+			std::pow(other.m_x - this->m_x, 2) +
+			std::pow(other.m_y - this->m_y, 2)
 		);
 	}
 
 	float Vec2::distanceSquaredFrom(Vec2 const& other) const
 	{
 		return (
-			std::powf(other.m_x - this->m_x, 2) +
-			std::powf(other.m_y - this->m_y, 2)
+			std::pow(other.m_x - this->m_x, 2) +
+			std::pow(other.m_y - this->m_y, 2)
 		);
 	}
 
@@ -89,17 +90,17 @@ namespace LibMath
 
 	float Vec2::magnitude(void) const
 	{
-		return std::sqrtf(
-			std::powf(this->m_x, 2) +
-			std::powf(this->m_y, 2)
+		return std::sqrt(
+			std::pow(this->m_x, 2) +
+			std::pow(this->m_y, 2)
 		);
 	}
 
 	float Vec2::magnitudeSquared(void) const
 	{
 		return (
-			std::powf(this->m_x, 2) +
-			std::powf(this->m_y, 2)
+			std::pow(this->m_x, 2) +
+			std::pow(this->m_y, 2)
 		);
 	}
 
@@ -138,8 +139,8 @@ namespace LibMath
 
 	Vec2& Vec2::rotate(Radian x, Radian y)
 	{
-		//this->m_x = this->m_x * std::cosf(y.radian(false));
-		//this->m_y = this->m_y * std::cosf(x.radian(false));
+		//this->m_x = this->m_x * std::cos(y.radian(false));
+		//this->m_y = this->m_y * std::cos(x.radian(false));
 
 		//return *this;
 
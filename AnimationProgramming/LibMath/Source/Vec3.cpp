@@ -3,6 +3,7 @@
 #include "LibMath/Vector/Vec4.h"
 #include "LibMath/Arithmetic.h"
 
+#include <cmath>
 #include <string>
 #include <sstream>
 
@@ -48,7 +49,7 @@ namespace LibMath
 	Radian Vec3::angleFrom(Vec3 const& other) const
 	{
 		float dot = this->dot(other);
-		float radian = std::acosf(Clamp(dot / (this->magnitude() * other.magnitude()), -1.f, 1.f));
+		float radian = std::acos(Clamp(dot / (this->magnitude() * other.magnitude()), -1.f, 1.f));
 
 		return Radian(radian);
 	}
@@ -79,25 +80,25 @@ namespace LibMath
 	float Vec3::distanceSquaredFrom(Vec3 const& other) const
 	{
 		return (
-			std::powf(other.m_x - m_x, 2) +
-			std::powf(other.m_y - m_y, 2) +
-			std::powf(other.m_z - m_z, 2)
+			std::pow(other.m_x - m_x, 2) +
+			std::pow(other.m_y - m_y, 2) +
+			std::pow(other.m_z - m_z, 2)
 		);
 	}
 
 	float Vec3::distance2DFrom(Vec3 const& other) const
 	{
-		return std::sqrtf(
-			std::powf(other.m_x - m_x, 2) +
-			std::powf(other.m_y - m_y, 2)
+		return std::sqrt(
+			std::pow(other.m_x - m_x, 2) +
+			std::pow(other.m_y - m_y, 2)
 		);
 	}
 
 	float Vec3::distance2DSquaredFrom(Vec3 const& other) const
 	{
 		return (
-			std::powf(other.m_x - m_x, 2) +
-			std::powf(other.m_y - m_y, 2)
+			std::pow(other.m_x - m_x, 2) +
+			std::pow(other.m_y - m_y, 2)
 			);;
 	}
 
@@ -127,19 +128,19 @@ namespace LibMath
 
 	float Vec3::magnitude(void) const
 	{
-		return std::sqrtf(
-			std::powf(m_x, 2) +
-			std::powf(m_y, 2) +
-			std::powf(m_z, 2)
+		return std::sqrt(
+			std::pow(m_x, 2) +
+			std::pow(m_y, 2) +
+			std::pow(m_z, 2)
 		);
 	}
 
 	float Vec3::magnitudeSquared(void) const
 	{
 		return (
-			std::powf(m_x, 2) +
-			std::powf(m_y, 2) +
-			std::powf(m_z, 2)
+			std::pow(m_x, 2) +
+			std::pow(m_y, 2) +
+			std::pow(m_z, 2)
 		);
 	}
 
@@ -179,14 +180,14 @@ namespace LibMath
 
 	Vec3& Vec3::rotate(Radian z, Radian x, Radian y)
 	{
-		float cosZ = std::cosf(z.radian(false));
-		float sinZ = std::sinf(z.radian(false));
+		float cosZ = std::cos(z.radian(false));
+		float sinZ = std::sin(z.radian(false));
 
-		float cosX = std::cosf(x.radian(false));
-		float sinX = std::sinf(x.radian(false));
+		float cosX = std::cos(x.radian(false));
+		float sinX = std::sin(x.radian(false));
 
-		float cosY = std::cosf(y.radian(false));
-		float sinY = std::sinf(y.radian(false));
+		float cosY = std::cos(y.radian(false));
+		float sinY = std::sin(y.radian(false));
 
 		float tempX = m_x * (cosZ * cosY + sinZ * sinX * sinY)
 					+ m_y * (-cosZ * sinY + sinZ * sinX * cosY)
@@ -207,8 +208,8 @@ namespace LibMath
 
 	Vec3& Vec3::rotate(Radian r, Vec3 const& other)
 	{
-		float cosR = std::cosf(r.radian(false));
-		float sinR = std::sinf(r.radian(false));
+		float cosR = std::cos(r.radian(false));
+		float sinR = std::sin(r.radian(false));
 
 		LibMath::Vec3 unitOther;
 
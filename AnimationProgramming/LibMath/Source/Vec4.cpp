@@ -3,6 +3,7 @@
 #include "LibMath/Vector/Vec2.h"
 #include "LibMath/Quaternion.h"
 
+#include <cmath>
 #include <string>
 #include <sstream>
 
@@ -19,44 +20,44 @@ namespace LibMath
 	Radian Vec4::angleFrom(Vec4 const& other) const
 	{
 		float dot = this->dot(other);
-		float radian = std::acosf(dot / (this->magnitude() * other.magnitude()));
+		float radian = std::acos(dot / (this->magnitude() * other.magnitude()));
 
 		return Radian(radian);
 	}
 
 	float Vec4::distanceFrom(Vec4 const& other) const
 	{
-		return std::sqrtf(
-			std::powf(other.m_x - this->m_x, 2) +
-			std::powf(other.m_y - this->m_y, 2) +
-			std::powf(other.m_z - this->m_z, 2) +
-			std::powf(other.m_w - this->m_w, 2)
+		return std::sqrt(
+			std::pow(other.m_x - this->m_x, 2) +
+			std::pow(other.m_y - this->m_y, 2) +
+			std::pow(other.m_z - this->m_z, 2) +
+			std::pow(other.m_w - this->m_w, 2)
 		);
 	}
 
 	float Vec4::distanceSquaredFrom(Vec4 const& other) const
 	{
 		return (
-			std::powf(other.m_x - this->m_x, 2) +
-			std::powf(other.m_y - this->m_y, 2) +
-			std::powf(other.m_z - this->m_z, 2) +
-			std::powf(other.m_w - this->m_w, 2)
+			std::pow(other.m_x - this->m_x, 2) +
+			std::pow(other.m_y - this->m_y, 2) +
+			std::pow(other.m_z - this->m_z, 2) +
+			std::pow(other.m_w - this->m_w, 2)
 		);
 	}
 
 	float Vec4::distance2DFrom(Vec4 const& other) const
 	{
-		return std::sqrtf(
-			std::powf(other.m_x - this->m_x, 2) +
-			std::powf(other.m_y - this->m_y, 2)
+		return std::sqrt(
+			std::pow(other.m_x - this->m_x, 2) +
+			std::pow(other.m_y - this->m_y, 2)
 		);
 	}
 
 	float Vec4::distance2DSquaredFrom(Vec4 const& other) const
 	{
 		return (
-			std::powf(other.m_x - this->m_x, 2) +
-			std::powf(other.m_y - this->m_y, 2)
+			std::pow(other.m_x - this->m_x, 2) +
+			std::pow(other.m_y - this->m_y, 2)
 		);
 	}
 
@@ -87,21 +88,21 @@ namespace LibMath
 
 	float Vec4::magnitude(void) const
 	{
-		return std::sqrtf(
-			std::powf(this->m_x, 2) +
-			std::powf(this->m_y, 2) +
-			std::powf(this->m_z, 2) +
-			std::powf(this->m_w, 2)
+		return std::sqrt(
+			std::pow(this->m_x, 2) +
+			std::pow(this->m_y, 2) +
+			std::pow(this->m_z, 2) +
+			std::pow(this->m_w, 2)
 		);
 	}
 
 	float Vec4::magnitudeSquared(void) const
 	{
 		return (
-			std::powf(this->m_x, 2) +
-			std::powf(this->m_y, 2) +
-			std::powf(this->m_z, 2) +
-			std::powf(this->m_w, 2)
+			std::pow(this->m_x, 2) +
+			std::pow(this->m_y, 2) +
+			std::pow(this->m_z, 2) +
+			std::pow(this->m_w, 2)
 		);
 	}
 
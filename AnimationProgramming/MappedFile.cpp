@@ -0,0 +1,92 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const char* path)
+{
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return;
+	}
+
+	LARGE_INTEGER size;
+	HANDLE		  mapping = nullptr;
+	if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+	{
+		mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	}
+
+	if (mapping == nullptr)
+	{
+		CloseHandle(file);
+		return;
+	}
+
+	m_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (m_data == nullptr)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return;
+	}
+
+	m_size = size_t(size.QuadPart);
+	m_file = file;
+	m_mapping = mapping;
+}
+
+MappedFile::~MappedFile()
+{
+	if (m_data != nullptr)
+	{
+		UnmapViewOfFile(m_data);
+		CloseHandle(m_mapping);
+		CloseHandle(m_file);
+	}
+}
+
+#else
+
+MappedFile::MappedFile(const char* path)
+{
+	int file = open(path, O_RDONLY);
+	if (file < 0)
+	{
+		return;
+	}
+
+	struct stat status;
+	if (fstat(file, &status) == 0 && status.st_size > 0)
+	{
+		void* data = mmap(nullptr, size_t(status.st_size), PROT_READ, MAP_SHARED, file, 0);
+		if (data != MAP_FAILED)
+		{
+			m_data = static_cast<const char*>(data);
+			m_size = size_t(status.st_size);
+		}
+	}
+
+	// The mapping keeps its own reference to the file
+	close(file);
+}
+
+MappedFile::~MappedFile()
+{
+	if (m_data != nullptr)
+	{
+		munmap(const_cast<char*>(m_data), m_size);
+	}
+}
+
+#endif
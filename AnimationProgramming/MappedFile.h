@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+
+// Read-only, shared memory mapping of a whole file: processes mapping the same file share its physical pages
+class MappedFile
+{
+  public:
+	MappedFile(const char* path);
+	~MappedFile();
+
+	MappedFile(MappedFile const&) = delete;
+	MappedFile& operator=(MappedFile const&) = delete;
+
+	bool isOpen() const
+	{
+		return m_data != nullptr;
+	}
+
+	const char* getData() const
+	{
+		return m_data;
+	}
+
+	size_t getSize() const
+	{
+		return m_size;
+	}
+
+  private:
+	const char* m_data = nullptr;
+	size_t		m_size = 0;
+
+#ifdef _WIN32
+	void* m_file = nullptr;
+	void* m_mapping = nullptr;
+#endif
+};
@@ -0,0 +1,160 @@
+#include "MeshBoneRemap.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+// A triangle references up to 3 vertices of 4 influences
+constexpr size_t MAX_TRIANGLE_BONES = 12;
+
+// Writes the up to 4 bones a vertex is skinned with: those with a weight, or the first one for vertices without weight
+// like SkinnedMesh. Returns their count.
+size_t getVertexBones(MeshFileVertex const& vertex, int* bones)
+{
+	float  weightSum = vertex.m_boneWeights[0] + vertex.m_boneWeights[1] + vertex.m_boneWeights[2] + vertex.m_boneWeights[3];
+	size_t count = 0;
+	for (size_t influence = 0; influence < 4; influence++)
+	{
+		if (!(vertex.m_boneIndices[influence] >= 0.f))
+		{
+			throw std::runtime_error("Negative or NaN bone index in mesh");
+		}
+
+		if (vertex.m_boneWeights[influence] > 0.f || (weightSum <= 0.f && influence == 0))
+		{
+			bones[count++] = int(vertex.m_boneIndices[influence]);
+		}
+	}
+	return count;
+}
+} // namespace
+
+MeshBoneRemap::MeshBoneRemap(MeshFile const& mesh, size_t maxBones)
+{
+	if (maxBones < MAX_TRIANGLE_BONES)
+	{
+		throw std::logic_error("A mesh section needs room for the bones of a whole triangle");
+	}
+
+	int boneLimit = 0;
+	for (MeshFileVertex const& vertex : mesh.m_Vertices)
+	{
+		int	   bones[4];
+		size_t count = getVertexBones(vertex, bones);
+		for (size_t bone = 0; bone < count; bone++)
+		{
+			boneLimit = std::max(boneLimit, bones[bone] + 1);
+		}
+	}
+
+	// Palette entry of each skeleton bone and section vertex of each mesh vertex in the section being filled, -1 when
+	// absent. Only the entries set by a section are cleared when the next one starts.
+	std::vector<int> paletteEntries(boneLimit, -1);
+	std::vector<int> sectionVertices(mesh.m_Vertices.size(), -1);
+	std::vector<bool> usedBones(boneLimit, false);
+
+	auto startSection = [&](size_t subMesh)
+	{
+		if (!m_Sections.empty())
+		{
+			for (int bone : m_Sections.back().m_Bones)
+			{
+				paletteEntries[bone] = -1;
+			}
+			for (uint32_t vertex : m_Sections.back().m_Vertices)
+			{
+				sectionVertices[vertex] = -1;
+			}
+		}
+		m_Sections.emplace_back().m_subMesh = subMesh;
+	};
+
+	for (size_t subMesh = 0; subMesh < mesh.m_SubMeshes.size(); subMesh++)
+	{
+		std::vector<uint32_t> const& indices = mesh.m_SubMeshes[subMesh].m_Indices;
+		if (indices.size() >= 3)
+		{
+			startSection(subMesh);
+		}
+
+		for (size_t triangle = 0; triangle + 3 <= indices.size(); triangle += 3)
+		{
+			int	   triangleBones[MAX_TRIANGLE_BONES];
+			size_t triangleBoneCount = 0;
+			for (size_t corner = 0; corner < 3; corner++)
+			{
+				triangleBoneCount += getVertexBones(mesh.m_Vertices[indices[triangle + corner]], triangleBones + triangleBoneCount);
+			}
+
+			size_t newBoneCount = 0;
+			for (size_t bone = 0; bone < triangleBoneCount; bone++)
+			{
+				bool repeated = std::find(triangleBones, triangleBones + bone, triangleBones[bone]) != triangleBones + bone;
+				if (!repeated && paletteEntries[triangleBones[bone]] < 0)
+				{
+					newBoneCount++;
+				}
+			}
+			if (m_Sections.back().m_Bones.size() + newBoneCount > maxBones)
+			{
+				startSection(subMesh);
+			}
+
+			MeshSection& section = m_Sections.back();
+			for (size_t bone = 0; bone < triangleBoneCount; bone++)
+			{
+				if (paletteEntries[triangleBones[bone]] < 0)
+				{
+					paletteEntries[triangleBones[bone]] = int(section.m_Bones.size());
+					section.m_Bones.push_back(triangleBones[bone]);
+					usedBones[triangleBones[bone]] = true;
+				}
+			}
+
+			for (size_t corner = 0; corner < 3; corner++)
+			{
+				uint32_t vertex = indices[triangle + corner];
+				if (sectionVertices[vertex] < 0)
+				{
+					sectionVertices[vertex] = int(section.m_Vertices.size());
+					section.m_Vertices.push_back(vertex);
+
+					// Influences without weight may name a bone out of the palette, they point at a kept one instead since
+					// their matrix is read all the same
+					MeshFileVertex const& source = mesh.m_Vertices[vertex];
+					int					  bones[4];
+					getVertexBones(source, bones);
+					for (size_t influence = 0; influence < 4; influence++)
+					{
+						int bone = int(source.m_boneIndices[influence]);
+						if (bone >= boneLimit || paletteEntries[bone] < 0)
+						{
+							bone = bones[0];
+						}
+						section.m_BoneIndices.push_back(float(paletteEntries[bone]));
+					}
+				}
+				section.m_Indices.push_back(uint32_t(sectionVertices[vertex]));
+			}
+		}
+	}
+
+	for (int bone = 0; bone < boneLimit; bone++)
+	{
+		if (usedBones[bone])
+		{
+			m_Bones.push_back(bone);
+		}
+	}
+}
+
+size_t MeshBoneRemap::getPaletteSize() const
+{
+	size_t size = 0;
+	for (MeshSection const& section : m_Sections)
+	{
+		size += section.m_Bones.size();
+	}
+	return size;
+}
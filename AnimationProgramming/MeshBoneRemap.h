@@ -0,0 +1,48 @@
+#pragma once
+
+#include "MeshFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Part of a mesh drawn with its own palette, which holds only the bones its triangles reference
+struct MeshSection
+{
+	size_t				  m_subMesh = 0; // Index in MeshFile::m_SubMeshes
+	std::vector<int>	  m_Bones;		 // Skeleton bone of each palette entry, in order of first use
+	std::vector<uint32_t> m_Vertices;	 // Mesh vertex of each section vertex
+	std::vector<float>	  m_BoneIndices; // 4 palette entries per section vertex, floats like MeshFileVertex
+	std::vector<uint32_t> m_Indices;	 // Triangle list indexing m_Vertices
+};
+
+// Bone remap table of a mesh, built at load from the bone indices of its vertices.
+// Only bones with a weight are kept, and each sub-mesh is split in sections of at most maxBones palette entries,
+// filled triangle after triangle: a new section starts when the next triangle would not fit the palette.
+// Vertices used by several sections are duplicated, each copy indexing the palette of its own section.
+class MeshBoneRemap
+{
+  public:
+	static constexpr size_t MAX_PALETTE_BONES = 64; // mat[64] of skinning.vs
+
+	MeshBoneRemap() = default;
+	MeshBoneRemap(MeshFile const& mesh, size_t maxBones = MAX_PALETTE_BONES);
+
+	std::vector<MeshSection> const& getSections() const
+	{
+		return m_Sections;
+	}
+
+	// Skeleton bones referenced by at least one section, in ascending order
+	std::vector<int> const& getBones() const
+	{
+		return m_Bones;
+	}
+
+	// Palette entries of all the sections, a bone shared by several sections counts once per section
+	size_t getPaletteSize() const;
+
+  private:
+	std::vector<MeshSection> m_Sections;
+	std::vector<int>		 m_Bones;
+};
@@ -0,0 +1,137 @@
+#include "MeshFile.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+static_assert(sizeof(MeshFileVertex) == 14 * sizeof(float), "MeshFileVertex must match the .msh vertex layout");
+
+namespace
+{
+class MeshReader
+{
+  public:
+	MeshReader(std::vector<char> const& bytes, const char* path) : m_Bytes(bytes), m_path(path)
+	{
+	}
+
+	void read(void* destination, size_t size)
+	{
+		if (size > m_Bytes.size() - m_offset)
+		{
+			throw std::runtime_error(std::string("Truncated mesh file ") + m_path);
+		}
+		memcpy(destination, m_Bytes.data() + m_offset, size);
+		m_offset += size;
+	}
+
+	uint32_t readU32()
+	{
+		uint32_t value;
+		read(&value, sizeof(value));
+		return value;
+	}
+
+  private:
+	std::vector<char> const& m_Bytes;
+	const char*				 m_path;
+	size_t					 m_offset = 0;
+};
+} // namespace
+
+MeshFile::MeshFile(const char* path)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file)
+	{
+		throw std::runtime_error(std::string("Cannot open mesh file ") + path);
+	}
+
+	std::vector<char> bytes(size_t(file.tellg()));
+	file.seekg(0);
+	if (!file.read(bytes.data(), bytes.size()))
+	{
+		throw std::runtime_error(std::string("Cannot read mesh file ") + path);
+	}
+
+	MeshReader reader(bytes, path);
+
+	uint32_t vertexCount = reader.readU32();
+	m_vertexFormat = reader.readU32();
+	reader.readU32();
+
+	// Counts are checked against the file size before anything is allocated
+	if (vertexCount > bytes.size() / sizeof(MeshFileVertex))
+	{
+		throw std::runtime_error(std::string("Truncated mesh file ") + path);
+	}
+	m_Vertices.resize(vertexCount);
+	reader.read(m_Vertices.data(), vertexCount * sizeof(MeshFileVertex));
+
+	// Bone indices end up as ints, checked as floats since converting a NaN or out of range value is undefined
+	for (MeshFileVertex const& vertex : m_Vertices)
+	{
+		for (float index : vertex.m_boneIndices)
+		{
+			if (!(index >= 0.f && index < float(INT32_MAX)))
+			{
+				throw std::runtime_error(std::string("Bone index out of range in mesh file ") + path);
+			}
+		}
+	}
+
+	uint32_t subMeshCount = reader.readU32();
+	if (subMeshCount > bytes.size() / (2 * sizeof(uint32_t)))
+	{
+		throw std::runtime_error(std::string("Truncated mesh file ") + path);
+	}
+	m_SubMeshes.resize(subMeshCount);
+
+	for (MeshFileSubMesh& subMesh : m_SubMeshes)
+	{
+		uint32_t indexCount = reader.readU32();
+		if (indexCount > bytes.size() / sizeof(uint32_t))
+		{
+			throw std::runtime_error(std::string("Truncated mesh file ") + path);
+		}
+		subMesh.m_Indices.resize(indexCount);
+		reader.read(subMesh.m_Indices.data(), indexCount * sizeof(uint32_t));
+		reader.readU32();
+
+		for (uint32_t index : subMesh.m_Indices)
+		{
+			if (index >= vertexCount)
+			{
+				throw std::runtime_error(std::string("Vertex index out of range in mesh file ") + path);
+			}
+		}
+	}
+}
+
+void MeshFile::remapBones(std::span<int const> boneIndices)
+{
+	for (MeshFileVertex& vertex : m_Vertices)
+	{
+		for (int influence = 0; influence < 4; influence++)
+		{
+			// Checked as a float, converting a NaN, negative or huge index to size_t is undefined
+			float sourceIndex = vertex.m_boneIndices[influence];
+			if (!(sourceIndex >= 0.f))
+			{
+				throw std::runtime_error("Negative or NaN bone index in mesh");
+			}
+
+			bool isInSkeleton = sourceIndex < float(boneIndices.size());
+			int	 bone = isInSkeleton ? boneIndices[size_t(sourceIndex)] : -1;
+			if (bone == -1 && vertex.m_boneWeights[influence] != 0.f)
+			{
+				std::string name = isInSkeleton ? std::to_string(size_t(sourceIndex)) : std::to_string(sourceIndex);
+				throw std::runtime_error("Mesh vertex weighted by bone " + name + " missing from the skeleton");
+			}
+
+			// Influences without weight only need a valid index
+			vertex.m_boneIndices[influence] = float(bone == -1 ? 0 : bone);
+		}
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Vertex of a .msh file, bone indices are stored as floats like the inputs of skinning.vs
+struct MeshFileVertex
+{
+	float m_position[3];
+	float m_normal[3];
+	float m_boneIndices[4];
+	float m_boneWeights[4]; // Not normalized, skinning.vs divides by their sum
+};
+
+// Triangle list of one part of the mesh
+struct MeshFileSubMesh
+{
+	std::vector<uint32_t> m_Indices;
+};
+
+// .msh layout: u32 vertexCount, u32 vertexFormat, u32 reserved, vertexCount * MeshFileVertex,
+// u32 subMeshCount, then subMeshCount * { u32 indexCount, u32 indices[indexCount], u32 reserved }
+struct MeshFile
+{
+	MeshFile() = default;
+	MeshFile(const char* path);
+
+	// Replaces the engine bone index of every influence by boneIndices[index], e.g. Skeleton::m_sourceToBone.
+	// Throws std::runtime_error if an index is negative or NaN, or if a weighted influence has no bone there (out of range
+	// or -1).
+	void remapBones(std::span<int const> boneIndices);
+
+	uint32_t					 m_vertexFormat = 0; // Engine vertex format, 11 for MeshFileVertex
+	std::vector<MeshFileVertex>	 m_Vertices;
+	std::vector<MeshFileSubMesh> m_SubMeshes;
+};
@@ -1,22 +1,320 @@
 #include "Skeleton.h"
 #include "Engine.h"
 
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+
+namespace
+{
+// Bones of a level composed per call of the batch kernel
+constexpr int CHUNK_SIZE = 16;
+
+void toPalette(LM_::ConstRigidTransforms const& skinning, LM_::Mat4* palette, size_t count)
+{
+	LM_::toAffineMat4(skinning, palette, count);
+}
+
+void toPalette(LM_::ConstRigidTransforms const& skinning, LM_::DualQuaternion* palette, size_t count)
+{
+	LM_::toDualQuaternions(skinning, palette, count);
+}
+
+void toPalette(LM_::ConstRigidTransforms const& skinning, LM_::AffineMat3x4* palette, size_t count)
+{
+	LM_::toAffineMat3x4(skinning, palette, count);
+}
+
+void toPalette(LM_::ConstRigidTransforms const& skinning, LM_::HalfAffineMat3x4* palette, size_t count)
+{
+	LM_::AffineMat3x4 rows[CHUNK_SIZE];
+	LM_::toAffineMat3x4(skinning, rows, count);
+	LM_::toHalfFloats(rows[0].m_rows[0], palette[0].m_rows[0], count * 12);
+}
+
+// model * inverseBind of every bone as a single rigid transform, converted to the palette a chunk at a time
+template<class Palette>
+void computePalette(Skeleton const& skeleton, Transform const* modelTransforms, Palette* palette)
+{
+	Transform skinning[CHUNK_SIZE];
+
+	for (size_t chunk = 0; chunk < skeleton.m_boneCount; chunk += CHUNK_SIZE)
+	{
+		size_t count = std::min(size_t(CHUNK_SIZE), skeleton.m_boneCount - chunk);
+
+		LM_::compose(getRigidTransforms(skeleton.m_inverseBindTransforms.data() + chunk),
+					 getRigidTransforms(modelTransforms + chunk), getRigidTransforms(skinning), count);
+		toPalette(getRigidTransforms(skinning), palette + chunk, count);
+	}
+}
+
+// Same products for the listed bones only, gathered a chunk at a time
+template<class Palette>
+void computePalette(Skeleton const& skeleton, Transform const* modelTransforms, std::span<int const> bones, Palette* palette)
+{
+	Transform skinning[CHUNK_SIZE];
+	Transform models[CHUNK_SIZE];
+
+	for (size_t chunk = 0; chunk < bones.size(); chunk += CHUNK_SIZE)
+	{
+		size_t count = std::min(size_t(CHUNK_SIZE), bones.size() - chunk);
+		for (size_t index = 0; index < count; index++)
+		{
+			skinning[index] = skeleton.m_inverseBindTransforms[bones[chunk + index]];
+			models[index] = modelTransforms[bones[chunk + index]];
+		}
+
+		LM_::compose(getRigidTransforms(skinning), getRigidTransforms(models), getRigidTransforms(skinning), count);
+		toPalette(getRigidTransforms(skinning), palette + chunk, count);
+	}
+}
+} // namespace
+
 Skeleton::Skeleton(size_t boneCount)
 {
-	m_Bones.reserve(boneCount);
+	std::vector<Bone> sourceBones;
+	sourceBones.reserve(boneCount);
+	for (int i = 0; i < int(boneCount); i++)
+	{
+		sourceBones.emplace_back(i);
+	}
 
-	int middleIKAdjuster = 0;
+	// ik_ bones, and whatever hangs below them, are left out wherever they are in the source order
+	enum class BoneState
+	{
+		E_UNVISITED,
+		E_VISITING,
+		E_KEPT,
+		E_IGNORED,
+	};
+	std::vector<BoneState> states(boneCount, BoneState::E_UNVISITED);
+
+	std::function<bool(int)> isKept = [&](int index)
+	{
+		if (states[index] == BoneState::E_VISITING)
+		{
+			throw std::logic_error("Skeleton hierarchy has a cycle");
+		}
+
+		if (states[index] == BoneState::E_UNVISITED)
+		{
+			states[index] = BoneState::E_VISITING;
 
-	for (int i = 0; i < boneCount; i++)
+			int	 parent = sourceBones[index].m_parentIndex;
+			bool kept = memcmp("ik_", sourceBones[index].m_Name, 3) != 0;
+			if (parent != -1)
+			{
+				if (parent < 0 || parent >= int(boneCount))
+				{
+					throw std::logic_error("Bone parent index out of range");
+				}
+				kept = kept && isKept(parent);
+			}
+
+			states[index] = kept ? BoneState::E_KEPT : BoneState::E_IGNORED;
+		}
+		return states[index] == BoneState::E_KEPT;
+	};
+
+	m_sourceToBone.assign(boneCount, -1);
+	for (int i = 0; i < int(boneCount); i++)
 	{
-		if (!memcmp("ik_", GetSkeletonBoneName(i), 3))
+		if (isKept(i))
 		{
-			middleIKAdjuster++;
-			continue;
+			m_sourceToBone[i] = int(m_Bones.size());
+			m_Bones.push_back(sourceBones[i]);
 		}
+	}
 
-		m_Bones.emplace_back(i, middleIKAdjuster);
+	for (Bone& bone : m_Bones)
+	{
+		if (bone.m_parentIndex != -1)
+		{
+			bone.m_parentIndex = m_sourceToBone[bone.m_parentIndex];
+		}
 	}
-	m_Bones.shrink_to_fit();
 	m_boneCount = m_Bones.size();
-}
\ No newline at end of file
+
+	flattenHierarchy();
+}
+
+void Skeleton::flattenHierarchy()
+{
+	// Parents are valid and acyclic at this point
+	std::vector<int> depths(m_boneCount, -1);
+	int				 levelCount = 0;
+	for (int index = 0; index < int(m_boneCount); index++)
+	{
+		int depth = 0;
+		for (int ancestor = m_Bones[index].m_parentIndex; ancestor != -1; ancestor = m_Bones[ancestor].m_parentIndex)
+		{
+			depth++;
+		}
+		depths[index] = depth;
+		levelCount = std::max(levelCount, depth + 1);
+	}
+
+	m_Levels.assign(levelCount, SkeletonLevel());
+	for (int depth : depths)
+	{
+		m_Levels[depth].m_end++;
+	}
+	for (int level = 0, begin = 0; level < levelCount; level++)
+	{
+		int count = m_Levels[level].m_end;
+		m_Levels[level] = { begin, begin + count };
+		begin += count;
+	}
+
+	// Bones of a level keep their relative order
+	m_flatBones.resize(m_boneCount);
+	m_flatParents.resize(m_boneCount);
+	std::vector<int> levelFill(levelCount, 0);
+	for (int index = 0; index < int(m_boneCount); index++)
+	{
+		int flatIndex = m_Levels[depths[index]].m_begin + levelFill[depths[index]]++;
+		m_flatBones[flatIndex] = index;
+		m_flatParents[flatIndex] = m_Bones[index].m_parentIndex;
+	}
+
+	SkeletonLod allBones;
+	for (int index = 0; index < int(m_boneCount); index++)
+	{
+		allBones.m_Bones.push_back(index);
+	}
+	m_Lods.assign(1, allBones);
+}
+
+bool Skeleton::isInSourceOrder() const
+{
+	for (size_t index = 0; index < m_Bones.size(); index++)
+	{
+		if (m_Bones[index].m_sourceIndex != int(index))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+int Skeleton::findBone(const char* name) const
+{
+	auto bone = std::find_if(m_Bones.begin(), m_Bones.end(), [name](Bone const& bone) { return strcmp(bone.m_Name, name) == 0; });
+	return bone != m_Bones.end() ? int(bone - m_Bones.begin()) : -1;
+}
+
+int Skeleton::addLod(std::span<const char* const> droppedNames, int maxDepth)
+{
+	// Parents are decided before their children, a level at a time
+	std::vector<bool> kept(m_boneCount, false);
+	for (int depth = 0; depth < int(m_Levels.size()) && depth <= maxDepth; depth++)
+	{
+		for (int flatIndex = m_Levels[depth].m_begin; flatIndex < m_Levels[depth].m_end; flatIndex++)
+		{
+			int			bone = m_flatBones[flatIndex];
+			int			parent = m_flatParents[flatIndex];
+			const char* name = m_Bones[bone].m_Name;
+
+			auto isNamed = [name](const char* part) { return name != nullptr && strstr(name, part) != nullptr; };
+			kept[bone] = (parent == -1 || kept[parent]) && std::none_of(droppedNames.begin(), droppedNames.end(), isNamed);
+		}
+	}
+
+	SkeletonLod lod;
+	for (int index = 0; index < int(m_boneCount); index++)
+	{
+		if (kept[index])
+		{
+			lod.m_Bones.push_back(index);
+		}
+	}
+	m_Lods.push_back(std::move(lod));
+	return int(m_Lods.size()) - 1;
+}
+
+LM_::ConstRigidTransforms Skeleton::getBindPose() const
+{
+	return getRigidTransforms(&m_Bones.front().m_localTransform, sizeof(Bone));
+}
+
+void Skeleton::localToModel(Transform const* localTransforms, Transform* modelTransforms) const
+{
+	Transform locals[CHUNK_SIZE];
+	Transform parents[CHUNK_SIZE];
+
+	for (SkeletonLevel const& level : m_Levels)
+	{
+		for (int chunk = level.m_begin; chunk < level.m_end; chunk += CHUNK_SIZE)
+		{
+			int count = std::min(CHUNK_SIZE, level.m_end - chunk);
+
+			// Roots only share a level with roots
+			if (m_flatParents[chunk] == -1)
+			{
+				for (int index = 0; index < count; index++)
+				{
+					modelTransforms[m_flatBones[chunk + index]] = localTransforms[m_flatBones[chunk + index]];
+				}
+				continue;
+			}
+
+			for (int index = 0; index < count; index++)
+			{
+				locals[index] = localTransforms[m_flatBones[chunk + index]];
+				parents[index] = modelTransforms[m_flatParents[chunk + index]];
+			}
+
+			LM_::compose(getRigidTransforms(locals), getRigidTransforms(parents), getRigidTransforms(locals), count);
+
+			for (int index = 0; index < count; index++)
+			{
+				modelTransforms[m_flatBones[chunk + index]] = locals[index];
+			}
+		}
+	}
+}
+
+void Skeleton::computeSkinningMatrices(Transform const* modelTransforms, LM_::Mat4* skinningMatrices) const
+{
+	computePalette(*this, modelTransforms, skinningMatrices);
+}
+
+void Skeleton::computeSkinningDualQuaternions(Transform const* modelTransforms, LM_::DualQuaternion* skinningDualQuaternions) const
+{
+	computePalette(*this, modelTransforms, skinningDualQuaternions);
+}
+
+void Skeleton::computeSkinningMatrices(Transform const* modelTransforms, LM_::AffineMat3x4* skinningMatrices) const
+{
+	computePalette(*this, modelTransforms, skinningMatrices);
+}
+
+void Skeleton::computeSkinningMatrices(Transform const* modelTransforms, LM_::HalfAffineMat3x4* skinningMatrices) const
+{
+	computePalette(*this, modelTransforms, skinningMatrices);
+}
+
+void Skeleton::computeSkinningMatrices(
+	Transform const* modelTransforms, std::span<int const> bones, LM_::Mat4* skinningMatrices) const
+{
+	computePalette(*this, modelTransforms, bones, skinningMatrices);
+}
+
+void Skeleton::computeSkinningDualQuaternions(
+	Transform const* modelTransforms, std::span<int const> bones, LM_::DualQuaternion* skinningDualQuaternions) const
+{
+	computePalette(*this, modelTransforms, bones, skinningDualQuaternions);
+}
+
+void Skeleton::computeSkinningMatrices(
+	Transform const* modelTransforms, std::span<int const> bones, LM_::AffineMat3x4* skinningMatrices) const
+{
+	computePalette(*this, modelTransforms, bones, skinningMatrices);
+}
+
+void Skeleton::computeSkinningMatrices(
+	Transform const* modelTransforms, std::span<int const> bones, LM_::HalfAffineMat3x4* skinningMatrices) const
+{
+	computePalette(*this, modelTransforms, bones, skinningMatrices);
+}
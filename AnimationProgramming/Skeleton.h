@@ -4,12 +4,82 @@
 #include "Transform.h"
 #include "vector"
 
+#include <climits>
+#include <span>
+
+// Bones [m_begin, m_end) of Skeleton::m_flatBones, all at the same depth
+struct SkeletonLevel
+{
+	int m_begin = 0;
+	int m_end = 0;
+};
+
+// Bones evaluated at one level of detail of a Skeleton, see Skeleton::addLod
+struct SkeletonLod
+{
+	std::vector<int> m_Bones; // Kept bones in increasing order, the parent of a kept bone is kept too
+};
+
 struct Skeleton
 {
 	Skeleton() = default;
 	Skeleton(size_t boneCount);
 
+	// Composes the local transforms of every bone with those of their ancestors, both arrays are indexed like m_Bones.
+	// Bones are processed a level at a time, several bones of a level at once with the LibMath batch kernels.
+	void localToModel(Transform const* localTransforms, Transform* modelTransforms) const;
+
+	// Whether every bone of m_Bones has its engine index, the bones left out all coming after the kept ones
+	bool isInSourceOrder() const;
+
+	// Index in m_Bones of the bone with that name, -1 if there is none
+	int findBone(const char* name) const;
+
+	// Adds a level of detail without the bones deeper than maxDepth (roots are at depth 0), those whose name contains
+	// one of droppedNames, and every bone below them. Returns its index in m_Lods, level 0 keeps every bone.
+	int addLod(std::span<const char* const> droppedNames, int maxDepth = INT_MAX);
+
+	// Local bind transforms of m_Bones, for the LibMath batch functions
+	LM_::ConstRigidTransforms getBindPose() const;
+
+	// Model transform of every bone times its inverse bind pose, built straight from the transforms without any Mat4
+	// product. Both arrays are indexed like m_Bones.
+	void computeSkinningMatrices(Transform const* modelTransforms, LM_::Mat4* skinningMatrices) const;
+
+	// Same products as computeSkinningMatrices, as dual quaternions: 8 floats per bone instead of 16
+	void computeSkinningDualQuaternions(Transform const* modelTransforms, LM_::DualQuaternion* skinningDualQuaternions) const;
+
+	// Rows of the matrices of computeSkinningMatrices without their constant last one: 12 floats per bone
+	void computeSkinningMatrices(Transform const* modelTransforms, LM_::AffineMat3x4* skinningMatrices) const;
+
+	// Same rows in half precision floats, 24 bytes per bone. Translations keep 11 significant bits.
+	void computeSkinningMatrices(Transform const* modelTransforms, LM_::HalfAffineMat3x4* skinningMatrices) const;
+
+	// Palettes of the listed bones only, in the layouts above: entry i is the one of bone bones[i], like the palette of
+	// a MeshSection
+	void computeSkinningMatrices(Transform const* modelTransforms, std::span<int const> bones, LM_::Mat4* skinningMatrices) const;
+	void computeSkinningDualQuaternions(
+		Transform const* modelTransforms, std::span<int const> bones, LM_::DualQuaternion* skinningDualQuaternions) const;
+	void computeSkinningMatrices(
+		Transform const* modelTransforms, std::span<int const> bones, LM_::AffineMat3x4* skinningMatrices) const;
+	void computeSkinningMatrices(
+		Transform const* modelTransforms, std::span<int const> bones, LM_::HalfAffineMat3x4* skinningMatrices) const;
+
 	size_t				   m_boneCount = 0;
 	std::vector<Bone>	   m_Bones;
 	std::vector<LM_::Mat4> m_inverseBindPoses;
-};
\ No newline at end of file
+	std::vector<Transform> m_inverseBindTransforms; // Same as m_inverseBindPoses
+
+	// Index in m_Bones of each bone of the engine skeleton, -1 for the ones left out
+	std::vector<int> m_sourceToBone;
+
+	// Hierarchy flattened parent first: roots, then their children, then their grandchildren...
+	std::vector<int>		   m_flatBones;	  // Index in m_Bones of each flat bone
+	std::vector<int>		   m_flatParents; // Index in m_Bones of the parent of each flat bone, -1 for roots
+	std::vector<SkeletonLevel> m_Levels;	  // Range of m_flatBones of each depth, roots first
+
+	std::vector<SkeletonLod> m_Lods; // Most detailed first
+
+  private:
+	void flattenHierarchy();
+};
@@ -0,0 +1,66 @@
+#include "SkeletonFile.h"
+
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+template <class T>
+T readValue(std::ifstream& file)
+{
+	T value{};
+	if (!file.read(reinterpret_cast<char*>(&value), sizeof(T)))
+	{
+		throw std::runtime_error("Unexpected end of skeleton file");
+	}
+	return value;
+}
+} // namespace
+
+SkeletonFile::SkeletonFile(const char* path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+	{
+		throw std::runtime_error(std::string("Cannot open skeleton file ") + path);
+	}
+
+	uint32_t boneCount = readValue<uint32_t>(file);
+	m_Bones.resize(boneCount);
+
+	for (uint32_t index = 0; index < boneCount; index++)
+	{
+		uint32_t nameLength = readValue<uint32_t>(file);
+		m_Bones[index].m_Name.resize(nameLength);
+		if (!file.read(m_Bones[index].m_Name.data(), nameLength))
+		{
+			throw std::runtime_error("Unexpected end of skeleton file");
+		}
+
+		readValue<int32_t>(file); // Bone index, always equal to its position in the file
+		m_Bones[index].m_parentIndex = readValue<int32_t>(file);
+	}
+
+	for (SkeletonFileBone& bone : m_Bones)
+	{
+		if (!file.read(reinterpret_cast<char*>(bone.m_position), sizeof(bone.m_position)) ||
+			!file.read(reinterpret_cast<char*>(bone.m_rotation), sizeof(bone.m_rotation)) ||
+			!file.read(reinterpret_cast<char*>(bone.m_scale), sizeof(bone.m_scale)))
+		{
+			throw std::runtime_error("Unexpected end of skeleton file");
+		}
+	}
+}
+
+int SkeletonFile::findBone(const char* name) const
+{
+	for (size_t index = 0; index < m_Bones.size(); index++)
+	{
+		if (m_Bones[index].m_Name == name)
+		{
+			return int(index);
+		}
+	}
+	return -1;
+}
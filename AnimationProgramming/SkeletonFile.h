@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Bind pose of one bone as stored in a .skel file (rotation is w, x, y, z)
+struct SkeletonFileBone
+{
+	std::string m_Name;
+	int			m_parentIndex = -1;
+	float		m_position[3] = { 0.f, 0.f, 0.f };
+	float		m_rotation[4] = { 1.f, 0.f, 0.f, 0.f };
+	float		m_scale[3] = { 1.f, 1.f, 1.f };
+};
+
+// .skel layout: u32 boneCount, boneCount * { u32 nameLength, char name[nameLength], i32 index, i32 parentIndex },
+// then boneCount * { float position[3], float rotation[4], float scale[3] }
+struct SkeletonFile
+{
+	SkeletonFile() = default;
+	SkeletonFile(const char* path);
+
+	int findBone(const char* name) const;
+
+	std::vector<SkeletonFileBone> m_Bones;
+};
@@ -0,0 +1,145 @@
+#include "SkinnedMesh.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+SkinnedMesh::SkinnedMesh(MeshFile const& file) : m_vertexCount(file.m_Vertices.size())
+{
+	for (size_t axis = 0; axis < 3; axis++)
+	{
+		m_BindPositions[axis].resize(m_vertexCount);
+		m_BindNormals[axis].resize(m_vertexCount);
+		m_Positions[axis].resize(m_vertexCount);
+		m_Normals[axis].resize(m_vertexCount);
+	}
+	for (size_t influence = 0; influence < 4; influence++)
+	{
+		m_BoneIndices[influence].resize(m_vertexCount);
+		m_BoneWeights[influence].resize(m_vertexCount);
+	}
+
+	for (size_t vertex = 0; vertex < m_vertexCount; vertex++)
+	{
+		MeshFileVertex const& source = file.m_Vertices[vertex];
+		for (size_t axis = 0; axis < 3; axis++)
+		{
+			m_BindPositions[axis][vertex] = source.m_position[axis];
+			m_BindNormals[axis][vertex] = source.m_normal[axis];
+		}
+
+		float weightSum = source.m_boneWeights[0] + source.m_boneWeights[1] + source.m_boneWeights[2] + source.m_boneWeights[3];
+		for (size_t influence = 0; influence < 4; influence++)
+		{
+			if (!(source.m_boneIndices[influence] >= 0.f))
+			{
+				throw std::runtime_error("Negative or NaN bone index in mesh");
+			}
+
+			m_BoneIndices[influence][vertex] = int32_t(source.m_boneIndices[influence]);
+			m_BoneWeights[influence][vertex] = weightSum > 0.f ? source.m_boneWeights[influence] / weightSum : 0.f;
+
+			// Unused influences still read their matrix with a zero weight, so they count too
+			m_boneCount = std::max<size_t>(m_boneCount, m_BoneIndices[influence][vertex] + 1);
+		}
+
+		// Vertices without weight follow their first bone instead of collapsing to the origin
+		if (weightSum <= 0.f)
+		{
+			m_BoneWeights[0][vertex] = 1.f;
+		}
+	}
+}
+
+void SkinnedMesh::skin(std::span<LM_::Mat4 const> palette, size_t begin, size_t end)
+{
+	skinRange(palette, begin, end);
+}
+
+void SkinnedMesh::skin(std::span<LM_::DualQuaternion const> palette, size_t begin, size_t end)
+{
+	skinRange(palette, begin, end);
+}
+
+void SkinnedMesh::skin(std::span<LM_::Mat4 const> palette, JobSystem& jobSystem)
+{
+	skinJobs(palette, jobSystem);
+}
+
+void SkinnedMesh::skin(std::span<LM_::DualQuaternion const> palette, JobSystem& jobSystem)
+{
+	skinJobs(palette, jobSystem);
+}
+
+template<class Palette>
+void SkinnedMesh::skinRange(std::span<Palette const> palette, size_t begin, size_t end)
+{
+	if (palette.size() < m_boneCount)
+	{
+		throw std::logic_error("Skinning palette smaller than the bones of the mesh");
+	}
+	if (begin > end || end > m_vertexCount)
+	{
+		throw std::logic_error("Skinning range out of the vertices of the mesh");
+	}
+
+	LM_::skin(getBindVertices(begin), palette.data(), getSkinnedVertices(begin), end - begin);
+}
+
+template<class Palette>
+void SkinnedMesh::skinJobs(std::span<Palette const> palette, JobSystem& jobSystem)
+{
+	if (palette.size() < m_boneCount)
+	{
+		throw std::logic_error("Skinning palette smaller than the bones of the mesh");
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	jobSystem.parallelFor(m_vertexCount, VERTICES_PER_JOB, [&](size_t begin, size_t end)
+						  { LM_::skin(getBindVertices(begin), palette.data(), getSkinnedVertices(begin), end - begin); });
+
+	m_skinSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+LM_::Vec3 SkinnedMesh::getPosition(size_t vertex) const
+{
+	return { m_Positions[0][vertex], m_Positions[1][vertex], m_Positions[2][vertex] };
+}
+
+LM_::Vec3 SkinnedMesh::getNormal(size_t vertex) const
+{
+	return { m_Normals[0][vertex], m_Normals[1][vertex], m_Normals[2][vertex] };
+}
+
+double SkinnedMesh::getVerticesPerSecond() const
+{
+	return m_skinSeconds > 0.0 ? m_vertexCount / m_skinSeconds : 0.0;
+}
+
+LM_::ConstSkinningVertices SkinnedMesh::getBindVertices(size_t begin) const
+{
+	LM_::ConstSkinningVertices vertices;
+	for (size_t axis = 0; axis < 3; axis++)
+	{
+		vertices.m_positions[axis] = m_BindPositions[axis].data() + begin;
+		vertices.m_normals[axis] = m_BindNormals[axis].data() + begin;
+	}
+	for (size_t influence = 0; influence < 4; influence++)
+	{
+		vertices.m_boneIndices[influence] = m_BoneIndices[influence].data() + begin;
+		vertices.m_boneWeights[influence] = m_BoneWeights[influence].data() + begin;
+	}
+	return vertices;
+}
+
+LM_::SkinnedVertices SkinnedMesh::getSkinnedVertices(size_t begin)
+{
+	LM_::SkinnedVertices vertices;
+	for (size_t axis = 0; axis < 3; axis++)
+	{
+		vertices.m_positions[axis] = m_Positions[axis].data() + begin;
+		vertices.m_normals[axis] = m_Normals[axis].data() + begin;
+	}
+	return vertices;
+}
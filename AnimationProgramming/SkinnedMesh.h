@@ -0,0 +1,73 @@
+#pragma once
+
+#include "JobSystem.h"
+#include "MeshFile.h"
+#include "pch.h"
+
+#include "LibMath/Batch.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// CPU copy of the skinning done by skinning.vs, for whoever needs the skinned vertices outside of the GPU.
+// The vertex stream of a MeshFile is split into one array per component (structure of arrays) so LM_::skin processes
+// a SIMD register of vertices at a time, and skin() spreads blocks of vertices over the workers of a JobSystem.
+class SkinnedMesh
+{
+  public:
+	SkinnedMesh() = default;
+	SkinnedMesh(MeshFile const& file);
+
+	size_t getVertexCount() const
+	{
+		return m_vertexCount;
+	}
+
+	// Highest bone index of the vertices plus one, the palette given to skin() needs at least that many matrices
+	size_t getBoneCount() const
+	{
+		return m_boneCount;
+	}
+
+	// Skins the vertices in [begin, end) of getVertexCount() with the skinning matrices or dual quaternions of a pose
+	void skin(std::span<LM_::Mat4 const> palette, size_t begin, size_t end);
+	void skin(std::span<LM_::DualQuaternion const> palette, size_t begin, size_t end);
+
+	// Skins every vertex, to be called from the thread owning jobSystem
+	void skin(std::span<LM_::Mat4 const> palette, JobSystem& jobSystem);
+	void skin(std::span<LM_::DualQuaternion const> palette, JobSystem& jobSystem);
+
+	// Results of the last skin()
+	LM_::Vec3 getPosition(size_t vertex) const;
+	LM_::Vec3 getNormal(size_t vertex) const;
+
+	// Throughput of the last skin() over every vertex
+	double getVerticesPerSecond() const;
+
+  private:
+	static constexpr size_t VERTICES_PER_JOB = 2048;
+
+	template<class Palette>
+	void skinRange(std::span<Palette const> palette, size_t begin, size_t end);
+
+	template<class Palette>
+	void skinJobs(std::span<Palette const> palette, JobSystem& jobSystem);
+
+	LM_::ConstSkinningVertices getBindVertices(size_t begin) const;
+	LM_::SkinnedVertices	   getSkinnedVertices(size_t begin);
+
+	size_t m_vertexCount = 0;
+	size_t m_boneCount = 0;
+
+	// Bind pose streams, weights normalized at load
+	std::vector<float>	 m_BindPositions[3];
+	std::vector<float>	 m_BindNormals[3];
+	std::vector<int32_t> m_BoneIndices[4];
+	std::vector<float>	 m_BoneWeights[4];
+
+	std::vector<float> m_Positions[3];
+	std::vector<float> m_Normals[3];
+
+	double m_skinSeconds = 0.0;
+};
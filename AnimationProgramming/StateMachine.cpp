@@ -0,0 +1,109 @@
+#include "StateMachine.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+StateMachine::StateMachine(BlendTree& tree, size_t boneCount)
+	: m_Tree(tree), m_Inertializer(boneCount), m_PreviousPose(boneCount), m_OlderPose(boneCount)
+{
+}
+
+int StateMachine::addState(int node)
+{
+	m_stateNodes.push_back(node);
+	if (m_currentState == -1)
+	{
+		m_currentState = 0;
+	}
+	return int(m_stateNodes.size()) - 1;
+}
+
+int StateMachine::addTransition(int fromState, int toState, float duration, std::vector<TransitionCondition> const& conditions)
+{
+	if (fromState < -1 || fromState >= int(m_stateNodes.size()) || toState < 0 || toState >= int(m_stateNodes.size()))
+	{
+		throw std::logic_error("State machine transition between unknown states");
+	}
+
+	m_Transitions.push_back({ fromState, toState, duration, conditions });
+
+	// Requests and triggers queue at most one entry per transition, the queue never grows past that
+	m_transitionQueue.reserve(m_Transitions.size() + 1);
+	return int(m_Transitions.size()) - 1;
+}
+
+void StateMachine::requestTransition(int transition)
+{
+	if (std::find(m_transitionQueue.begin(), m_transitionQueue.end(), transition) == m_transitionQueue.end())
+	{
+		m_transitionQueue.push_back(transition);
+	}
+}
+
+bool StateMachine::isReady(Transition const& transition) const
+{
+	if ((transition.m_fromState != -1 && transition.m_fromState != m_currentState) ||
+		transition.m_toState == m_currentState || transition.m_Conditions.empty())
+	{
+		return false;
+	}
+
+	return std::all_of(
+		transition.m_Conditions.begin(), transition.m_Conditions.end(),
+		[this](TransitionCondition const& condition)
+		{
+			float value = m_Tree.getParameter(condition.m_parameter);
+			return condition.m_type == ConditionType::E_GREATER ? value > condition.m_threshold : value < condition.m_threshold;
+		});
+}
+
+void StateMachine::evaluate(float frameTime, FrameArena& arena, std::span<Transform> localPose)
+{
+	if (m_currentState == -1)
+	{
+		throw std::logic_error("State machine without states");
+	}
+
+	// Triggers wait for the requests to be handled, then the first transition ready joins the queue
+	if (m_transitionQueue.empty())
+	{
+		auto ready = std::find_if(
+			m_Transitions.begin(), m_Transitions.end(), [this](Transition const& transition) { return isReady(transition); });
+		if (ready != m_Transitions.end())
+		{
+			m_transitionQueue.push_back(int(ready - m_Transitions.begin()));
+		}
+	}
+
+	Transition const* started = nullptr;
+	while (!m_transitionQueue.empty() && started == nullptr)
+	{
+		Transition const& transition = m_Transitions[m_transitionQueue.front()];
+		m_transitionQueue.erase(m_transitionQueue.begin());
+
+		if ((transition.m_fromState == -1 || transition.m_fromState == m_currentState) && transition.m_toState != m_currentState)
+		{
+			started = &transition;
+			m_currentState = transition.m_toState;
+		}
+	}
+
+	m_Tree.evaluate(m_stateNodes[m_currentState], frameTime, arena, localPose);
+
+	// Offsets are measured against the new state as it is now, the previous pose being one frame older
+	if (started != nullptr && m_historySize > 0)
+	{
+		m_Inertializer.start(
+			m_PreviousPose, m_OlderPose, m_historySize > 1 ? m_previousFrameTime : 0.f, localPose, started->m_duration);
+		m_transitionTime = 0.f;
+	}
+
+	// The first frame of a transition applies the whole offsets, at 0 seconds
+	m_Inertializer.apply(localPose, m_transitionTime);
+	m_transitionTime += frameTime;
+
+	std::swap(m_PreviousPose, m_OlderPose);
+	std::copy(localPose.begin(), localPose.end(), m_PreviousPose.begin());
+	m_previousFrameTime = frameTime;
+	m_historySize = std::min(m_historySize + 1, 2);
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "BlendTree.h"
+#include "FrameArena.h"
+#include "Inertialization.h"
+#include "Transform.h"
+
+#include <span>
+#include <vector>
+
+enum class ConditionType
+{
+	E_GREATER,
+	E_LESS,
+};
+
+// Test of a BlendTree parameter against a threshold
+struct TransitionCondition
+{
+	int			  m_parameter = -1;
+	ConditionType m_type = ConditionType::E_GREATER;
+	float		  m_threshold = 0.f;
+};
+
+// Switches between nodes of a BlendTree. Each state plays one node of the tree, transitions lead to another state once
+// all their conditions on the tree parameters hold, or when requested. Both go through a queue and at most one
+// transition starts per evaluate().
+// Transitions are inertialized: from the switch on only the new state is evaluated, and the offset to the last pose
+// of the previous one fades out over the duration of the transition (see PoseInertializer).
+class StateMachine
+{
+  public:
+	StateMachine(BlendTree& tree, size_t boneCount);
+
+	// Returns the index of the new state, the first state added is the initial one
+	int addState(int node);
+
+	// Returns the index of the new transition. fromState -1 leaves any state, transitions without conditions only
+	// happen when requested.
+	int addTransition(int fromState, int toState, float duration, std::vector<TransitionCondition> const& conditions);
+
+	// Dropped if the machine is not in the source state of the transition by the time it leaves the queue, and
+	// ignored if the transition is already queued
+	void requestTransition(int transition);
+
+	// Starts the next transition, then writes the local pose of the current state and what is left of the
+	// previous one. Temporary poses come from arena.
+	void evaluate(float frameTime, FrameArena& arena, std::span<Transform> localPose);
+
+	int getCurrentState() const
+	{
+		return m_currentState;
+	}
+
+	bool isInTransition() const
+	{
+		return m_Inertializer.isActive(m_transitionTime);
+	}
+
+  private:
+	struct Transition
+	{
+		int								 m_fromState = -1;
+		int								 m_toState = -1;
+		float							 m_duration = 0.f;
+		std::vector<TransitionCondition> m_Conditions;
+	};
+
+	bool isReady(Transition const& transition) const;
+
+	BlendTree&				m_Tree;
+	std::vector<int>		m_stateNodes; // Node of the tree played by each state
+	std::vector<Transition> m_Transitions;
+	std::vector<int>		m_transitionQueue;
+	int						m_currentState = -1;
+
+	PoseInertializer m_Inertializer;
+	float			 m_transitionTime = 0.f; // Seconds from the start of the last transition to the next frame
+
+	// Last two poses output, the offsets and their velocities of a new transition are measured on them
+	std::vector<Transform> m_PreviousPose;
+	std::vector<Transform> m_OlderPose;
+	float				   m_previousFrameTime = 0.f;
+	int					   m_historySize = 0; // Poses output so far, up to 2
+};
@@ -1,5 +1,7 @@
 #include "Transform.h"
 
+#include <cmath>
+
 Transform::Transform(void)
 {
 	m_Position = LM_::Vec3::zero();
@@ -13,10 +15,7 @@ Transform::Transform(LM_::Vec3 pos, LM_::Quaternion rot)
 
 Transform::operator LM_::Mat4() const
 {
-	LM_::Mat4 transMat = LM_::Mat4::Translate(m_Position);
-	LM_::Mat4 quatMat = LM_::toRotationMat4(m_Rotation);
-
-	return (transMat * quatMat);
+	return LM_::toAffineMat4(m_Rotation, m_Position);
 }
 
 Transform operator-(Transform const& pRight)
@@ -41,3 +40,37 @@ Transform interpolate(Transform const& pLeft, Transform const& pRight, float pAl
 {
 	return Transform(LM_::Lerp(pLeft.m_Position, pRight.m_Position, pAlpha), LM_::slerp(pLeft.m_Rotation, pRight.m_Rotation, pAlpha));
 }
+
+Transform extrapolate(Transform const& pPrevious, Transform const& pLast, float pAlpha)
+{
+	// Rotations are extended linearly then normalized, close enough to a slerp over the few frames between two poses.
+	// Spelled out per component, this runs for every bone of the skipped characters.
+	LM_::Quaternion const& previous = pPrevious.m_Rotation;
+	LM_::Quaternion const& last = pLast.m_Rotation;
+	float hemisphere = previous.m_a * last.m_a + previous.m_b * last.m_b + previous.m_c * last.m_c + previous.m_d * last.m_d < 0.f
+						   ? -1.f
+						   : 1.f;
+	float previousWeight = hemisphere * (1.f - pAlpha);
+	float a = previous.m_a * previousWeight + last.m_a * pAlpha;
+	float b = previous.m_b * previousWeight + last.m_b * pAlpha;
+	float c = previous.m_c * previousWeight + last.m_c * pAlpha;
+	float d = previous.m_d * previousWeight + last.m_d * pAlpha;
+	float inverseLength = 1.f / std::sqrt(a * a + b * b + c * c + d * d);
+
+	LM_::Vec3 const& previousPosition = pPrevious.m_Position;
+	LM_::Vec3 const& lastPosition = pLast.m_Position;
+	return Transform(LM_::Vec3(previousPosition.m_x + (lastPosition.m_x - previousPosition.m_x) * pAlpha,
+							   previousPosition.m_y + (lastPosition.m_y - previousPosition.m_y) * pAlpha,
+							   previousPosition.m_z + (lastPosition.m_z - previousPosition.m_z) * pAlpha),
+					 LM_::Quaternion(a * inverseLength, b * inverseLength, c * inverseLength, d * inverseLength));
+}
+
+LM_::RigidTransforms getRigidTransforms(Transform* first, size_t stride)
+{
+	return { &first->m_Position, &first->m_Rotation, stride };
+}
+
+LM_::ConstRigidTransforms getRigidTransforms(Transform const* first, size_t stride)
+{
+	return { &first->m_Position, &first->m_Rotation, stride };
+}
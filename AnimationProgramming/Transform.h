@@ -1,6 +1,7 @@
 #pragma once
 
 #include "pch.h"
+#include "LibMath/Batch.h"
 
 struct Transform
 {
@@ -20,3 +21,10 @@ Transform operator*(Transform pLeft, Transform const& pRight);
 Transform& operator*=(Transform& pLeftRef, Transform const& pRight);
 
 Transform interpolate(Transform const& pLeft, Transform const& pRight, float pAlpha);
+
+// Continues the motion from pPrevious to pLast: pAlpha 1 gives pLast, 2 as far again past it
+Transform extrapolate(Transform const& pPrevious, Transform const& pLast, float pAlpha);
+
+// Views of transforms for the LibMath batch functions, stride is the number of bytes between two transforms
+LM_::RigidTransforms	  getRigidTransforms(Transform* first, size_t stride = sizeof(Transform));
+LM_::ConstRigidTransforms getRigidTransforms(Transform const* first, size_t stride = sizeof(Transform));
@@ -1,9 +1,21 @@
 #include "CustomSimulation.h"
 
-int main()
+#ifdef HEADLESS_ENGINE
+#include "HeadlessEngine.h"
+#endif
+
+int main(int argc, char** argv)
 {
+#ifdef HEADLESS_ENGINE
+	HeadlessParseArguments(argc, argv);
+#endif
+
 	CustomSimulation simulatte;
 	Run(&simulatte, 1400, 800);
 
+#ifdef HEADLESS_ENGINE
+	return HeadlessGetExitCode();
+#else
 	return 0;
+#endif
 }
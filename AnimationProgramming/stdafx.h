@@ -5,10 +5,13 @@
 
 #pragma once
 
+#ifdef _WIN32
 #include "targetver.h"
 
-#include <stdio.h>
 #include <tchar.h>
+#endif
+
+#include <stdio.h>
 
 
 
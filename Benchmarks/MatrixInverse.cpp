@@ -0,0 +1,158 @@
+// Times the Mat4 inverses against the former minors based one, with the residual of each:
+// ./MatrixInverseBenchmark [matrix count] [repeat count]
+#include "LibMath/Batch.h"
+#include "LibMath/Quaternion.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace LM_ = LibMath;
+
+namespace
+{
+// GetInverse as it was before the closed-form expansion
+LM_::Mat4 inverseByMinors(LM_::Mat4 const& matrix)
+{
+	LM_::Mat4 inverse = matrix.GetCofactors().ToTranspose();
+	inverse *= (1 / matrix.GetDeterminant());
+	return inverse;
+}
+
+// Largest element of matrix * inverse - identity, computed in double
+double maxResidual(std::vector<LM_::Mat4> const& matrices, std::vector<LM_::Mat4> const& inverses)
+{
+	double residual = 0.0;
+	for (size_t index = 0; index < matrices.size(); index++)
+	{
+		for (int column = 0; column < 4; column++)
+		{
+			for (int row = 0; row < 4; row++)
+			{
+				double element = column == row ? -1.0 : 0.0;
+				for (int k = 0; k < 4; k++)
+				{
+					element += double(matrices[index][k][row]) * inverses[index][column][k];
+				}
+				residual = std::max(residual, std::fabs(element));
+			}
+		}
+	}
+	return residual;
+}
+
+void report(char const* name, std::vector<LM_::Mat4> const& matrices, std::vector<LM_::Mat4> const& inverses, int repeatCount,
+			std::function<void()> const& invertAll)
+{
+	auto start = std::chrono::steady_clock::now();
+	for (int repeat = 0; repeat < repeatCount; repeat++)
+	{
+		invertAll();
+	}
+	double nanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+	std::printf("  %-24s %8.2f ns/matrix, max residual %g\n", name, nanoseconds / (double(repeatCount) * inverses.size()),
+				maxResidual(matrices, inverses));
+}
+
+void benchmark(char const* kind, std::vector<LM_::Mat4> const& matrices, int repeatCount, bool isAffine, bool isRigid)
+{
+	std::vector<LM_::Mat4> reference(matrices.size());
+	std::vector<LM_::Mat4> result(matrices.size());
+
+	std::printf("%s matrices\n", kind);
+	report("minors (former)", matrices, reference, repeatCount,
+		   [&]
+		   {
+			   for (size_t index = 0; index < matrices.size(); index++)
+			   {
+				   reference[index] = inverseByMinors(matrices[index]);
+			   }
+		   });
+	report("GetInverse", matrices, result, repeatCount,
+		   [&]
+		   {
+			   for (size_t index = 0; index < matrices.size(); index++)
+			   {
+				   result[index] = matrices[index].GetInverse();
+			   }
+		   });
+	report("batch invert", matrices, result, repeatCount, [&] { LM_::invert(matrices.data(), result.data(), matrices.size()); });
+
+	if (isAffine)
+	{
+		report("GetAffineInverse", matrices, result, repeatCount,
+			   [&]
+			   {
+				   for (size_t index = 0; index < matrices.size(); index++)
+				   {
+					   result[index] = matrices[index].GetAffineInverse();
+				   }
+			   });
+		report("batch invertAffine", matrices, result, repeatCount,
+			   [&] { LM_::invertAffine(matrices.data(), result.data(), matrices.size()); });
+	}
+
+	if (isRigid)
+	{
+		report("GetRigidInverse", matrices, result, repeatCount,
+			   [&]
+			   {
+				   for (size_t index = 0; index < matrices.size(); index++)
+				   {
+					   result[index] = matrices[index].GetRigidInverse();
+				   }
+			   });
+		report("batch invertRigid", matrices, result, repeatCount,
+			   [&] { LM_::invertRigid(matrices.data(), result.data(), matrices.size()); });
+	}
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	size_t matrixCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4096;
+	int	   repeatCount = argc > 2 ? std::atoi(argv[2]) : 100;
+
+	char const* levels[] = { "scalar", "SSE", "AVX2" };
+	std::printf("Batch functions use %s\n", levels[int(LM_::getSimdLevel())]);
+
+	std::mt19937						  random(42);
+	std::uniform_real_distribution<float> unit(-1.f, 1.f);
+
+	std::vector<LM_::Mat4> rigid, affine, general;
+	for (size_t index = 0; index < matrixCount; index++)
+	{
+		LM_::Quaternion rotation(unit(random), unit(random), unit(random), unit(random));
+		LM_::Vec3		translation(unit(random) * 100.f, unit(random) * 100.f, unit(random) * 100.f);
+		rigid.push_back(LM_::toAffineMat4(rotation, translation));
+
+		LM_::Mat4 scaled = rigid.back();
+		for (int column = 0; column < 3; column++)
+		{
+			for (int row = 0; row < 3; row++)
+			{
+				scaled[column][row] *= 1.f + 0.5f * unit(random);
+			}
+		}
+		affine.push_back(scaled);
+
+		LM_::Mat4 any = scaled;
+		for (int column = 0; column < 4; column++)
+		{
+			any[column][3] = column == 3 ? 1.f + 0.5f * unit(random) : 0.1f * unit(random);
+		}
+		general.push_back(any);
+	}
+
+	benchmark("Rigid", rigid, repeatCount, true, true);
+	benchmark("Affine", affine, repeatCount, true, false);
+	benchmark("General", general, repeatCount, false, false);
+
+	return 0;
+}
@@ -0,0 +1,93 @@
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+
+namespace
+{
+int openCounter(uint64_t config)
+{
+	perf_event_attr attributes;
+	std::memset(&attributes, 0, sizeof(attributes));
+	attributes.type = PERF_TYPE_HARDWARE;
+	attributes.size = sizeof(attributes);
+	attributes.config = config;
+	attributes.disabled = 1;
+	attributes.exclude_kernel = 1;
+	attributes.exclude_hv = 1;
+
+	return int(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+}
+} // namespace
+
+PerfCounters::PerfCounters()
+{
+	m_descriptors[E_CYCLES] = openCounter(PERF_COUNT_HW_CPU_CYCLES);
+	m_descriptors[E_INSTRUCTIONS] = openCounter(PERF_COUNT_HW_INSTRUCTIONS);
+	m_descriptors[E_CACHE_MISSES] = openCounter(PERF_COUNT_HW_CACHE_MISSES);
+}
+
+PerfCounters::~PerfCounters()
+{
+	for (int descriptor : m_descriptors)
+	{
+		if (descriptor != -1)
+		{
+			close(descriptor);
+		}
+	}
+}
+
+void PerfCounters::start()
+{
+	for (int descriptor : m_descriptors)
+	{
+		if (descriptor != -1)
+		{
+			ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+			ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+}
+
+void PerfCounters::stop()
+{
+	for (int counter = 0; counter < E_COUNT; counter++)
+	{
+		int descriptor = m_descriptors[counter];
+		if (descriptor != -1)
+		{
+			ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+			if (read(descriptor, &m_values[counter], sizeof(uint64_t)) != sizeof(uint64_t))
+			{
+				m_values[counter] = 0;
+			}
+		}
+	}
+}
+#else
+PerfCounters::PerfCounters()
+{
+	for (int& descriptor : m_descriptors)
+	{
+		descriptor = -1;
+	}
+}
+
+PerfCounters::~PerfCounters()
+{
+}
+
+void PerfCounters::start()
+{
+}
+
+void PerfCounters::stop()
+{
+}
+#endif
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+// Hardware counters of the calling thread, read with perf_event_open on Linux.
+// Counters the kernel refuses (no PMU in a VM, perf_event_paranoid too high) or other platforms report as unavailable,
+// the benchmarks then only give times.
+class PerfCounters
+{
+  public:
+	enum Counter
+	{
+		E_CYCLES,
+		E_INSTRUCTIONS,
+		E_CACHE_MISSES,
+		E_COUNT,
+	};
+
+	PerfCounters();
+	~PerfCounters();
+
+	PerfCounters(PerfCounters const&) = delete;
+	PerfCounters& operator=(PerfCounters const&) = delete;
+
+	void start();
+	void stop();
+
+	bool isAvailable(Counter counter) const
+	{
+		return m_descriptors[counter] != -1;
+	}
+
+	// Events between the last start() and stop()
+	uint64_t getValue(Counter counter) const
+	{
+		return m_values[counter];
+	}
+
+  private:
+	int		 m_descriptors[E_COUNT];
+	uint64_t m_values[E_COUNT] = {};
+};
@@ -0,0 +1,669 @@
+// Times each stage of pose evaluation on the shipped Walk and Run clips, per iteration and per bone, and the CPU
+// skinning of the mannequin per vertex, with the hardware counters of PerfCounters when the system grants them:
+// ./PoseEvaluationBenchmark [--json path] [--filter text] [--min-time seconds] [--characters count] [--workers count]
+#include "PerfCounters.h"
+
+#include "Animation.h"
+#include "AnimationFile.h"
+#include "AnimationLod.h"
+#include "BlendTree.h"
+#include "CharacterInstances.h"
+#include "Engine.h"
+#include "FrameArena.h"
+#include "JobSystem.h"
+#include "KeyPairCache.h"
+#include "MeshBoneRemap.h"
+#include "MeshFile.h"
+#include "Skeleton.h"
+#include "SkinnedMesh.h"
+#include "Transform.h"
+
+#include "LibMath/Batch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace LM_ = LibMath;
+
+namespace
+{
+constexpr float FRAME_TIME = 1.f / 60.f;
+
+struct Options
+{
+	const char*	 m_jsonPath = nullptr;
+	const char*	 m_filter = nullptr;
+	double		 m_minSeconds = 0.2;
+	size_t		 m_characterCount = 256;
+	unsigned int m_workerCount = 1;
+};
+
+// What one iteration processes, and the JSON keys of its count and time per element
+struct Unit
+{
+	const char* m_name;
+	const char* m_countKey;
+	const char* m_timeKey;
+	bool		m_hasThroughput; // Also reports elements per second
+};
+
+constexpr Unit BONES = { "bone", "bones", "nsPerBone", false };
+constexpr Unit VERTICES = { "vertex", "vertices", "nsPerVertex", true };
+
+struct Result
+{
+	std::string m_name;
+	Unit const* m_Unit = &BONES;
+	size_t		m_elementCount = 0; // Elements processed per iteration
+	size_t		m_iterations = 0;
+	double		m_nanoseconds = 0.0; // Per iteration
+	bool		m_hasCounter[PerfCounters::E_COUNT] = {};
+	double		m_counters[PerfCounters::E_COUNT] = {}; // Per iteration
+};
+
+// Keeps the compiler from dropping work whose result is never read
+void keepAlive(void const* data)
+{
+#if defined(__GNUC__)
+	asm volatile("" : : "g"(data) : "memory");
+#else
+	static void const* volatile s_sink;
+	s_sink = data;
+#endif
+}
+
+class Suite
+{
+  public:
+	explicit Suite(Options const& options) : m_Options(options)
+	{
+	}
+
+	// body runs one iteration, which processes boneCount bones
+	void run(const char* name, size_t boneCount, std::function<void(size_t iteration)> const& body)
+	{
+		run(name, BONES, boneCount, body);
+	}
+
+	void run(const char* name, Unit const& unit, size_t elementCount, std::function<void(size_t iteration)> const& body)
+	{
+		if (m_Options.m_filter != nullptr && std::strstr(name, m_Options.m_filter) == nullptr)
+		{
+			return;
+		}
+
+		body(0);
+
+		// Doubles the iteration count until one batch lasts the minimum time, the counters cover that batch
+		size_t iterations = 1;
+		double seconds = 0.0;
+		while (true)
+		{
+			m_Counters.start();
+			auto start = std::chrono::steady_clock::now();
+			for (size_t iteration = 0; iteration < iterations; iteration++)
+			{
+				body(iteration);
+			}
+			seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			m_Counters.stop();
+
+			if (seconds >= m_Options.m_minSeconds)
+			{
+				break;
+			}
+			iterations *= 2;
+		}
+
+		Result result;
+		result.m_name = name;
+		result.m_Unit = &unit;
+		result.m_elementCount = elementCount;
+		result.m_iterations = iterations;
+		result.m_nanoseconds = seconds * 1e9 / iterations;
+		for (int counter = 0; counter < PerfCounters::E_COUNT; counter++)
+		{
+			result.m_hasCounter[counter] = m_Counters.isAvailable(PerfCounters::Counter(counter));
+			result.m_counters[counter] = double(m_Counters.getValue(PerfCounters::Counter(counter))) / iterations;
+		}
+
+		double nanosecondsPerElement = result.m_nanoseconds / elementCount;
+		std::printf("%-36s %12.1f ns %9.2f ns/%s", name, result.m_nanoseconds, nanosecondsPerElement, unit.m_name);
+		if (unit.m_hasThroughput)
+		{
+			std::printf(" %9.1f M %s/s", 1e3 / nanosecondsPerElement, unit.m_countKey);
+		}
+		if (result.m_hasCounter[PerfCounters::E_CYCLES])
+		{
+			std::printf(" %12.0f cycles", result.m_counters[PerfCounters::E_CYCLES]);
+		}
+		if (result.m_hasCounter[PerfCounters::E_CACHE_MISSES])
+		{
+			std::printf(" %10.1f cache misses", result.m_counters[PerfCounters::E_CACHE_MISSES]);
+		}
+		std::printf("\n");
+
+		m_Results.push_back(std::move(result));
+	}
+
+	bool writeJson(const char* path) const
+	{
+		FILE* file = std::fopen(path, "w");
+		if (file == nullptr)
+		{
+			return false;
+		}
+
+		const char* simdLevels[] = { "scalar", "sse", "avx2" };
+		const char* counterNames[] = { "cyclesPerIteration", "instructionsPerIteration", "cacheMissesPerIteration" };
+
+		std::fprintf(file, "{\n  \"simdLevel\": \"%s\",\n  \"benchmarks\": [\n", simdLevels[int(LM_::getSimdLevel())]);
+		for (size_t index = 0; index < m_Results.size(); index++)
+		{
+			Result const& result = m_Results[index];
+			double		  nanosecondsPerElement = result.m_nanoseconds / result.m_elementCount;
+			std::fprintf(file, "    {\"name\": \"%s\", \"%s\": %zu, \"iterations\": %zu, \"nsPerIteration\": %.3f, \"%s\": %.4f",
+						 result.m_name.c_str(), result.m_Unit->m_countKey, result.m_elementCount, result.m_iterations,
+						 result.m_nanoseconds, result.m_Unit->m_timeKey, nanosecondsPerElement);
+			if (result.m_Unit->m_hasThroughput)
+			{
+				std::fprintf(file, ", \"%sPerSecond\": %.0f", result.m_Unit->m_countKey, 1e9 / nanosecondsPerElement);
+			}
+			for (int counter = 0; counter < PerfCounters::E_COUNT; counter++)
+			{
+				if (result.m_hasCounter[counter])
+				{
+					std::fprintf(file, ", \"%s\": %.1f", counterNames[counter], result.m_counters[counter]);
+				}
+				else
+				{
+					std::fprintf(file, ", \"%s\": null", counterNames[counter]);
+				}
+			}
+			std::fprintf(file, "}%s\n", index + 1 < m_Results.size() ? "," : "");
+		}
+		std::fprintf(file, "  ]\n}\n");
+
+		return std::fclose(file) == 0;
+	}
+
+  private:
+	Options const&		m_Options;
+	PerfCounters		m_Counters;
+	std::vector<Result> m_Results;
+};
+
+bool parseOptions(int argc, char** argv, Options& options)
+{
+	for (int index = 1; index < argc; index++)
+	{
+		bool hasValue = index + 1 < argc;
+		if (!std::strcmp(argv[index], "--json") && hasValue)
+		{
+			options.m_jsonPath = argv[++index];
+		}
+		else if (!std::strcmp(argv[index], "--filter") && hasValue)
+		{
+			options.m_filter = argv[++index];
+		}
+		else if (!std::strcmp(argv[index], "--min-time") && hasValue)
+		{
+			options.m_minSeconds = std::strtod(argv[++index], nullptr);
+		}
+		else if (!std::strcmp(argv[index], "--characters") && hasValue)
+		{
+			options.m_characterCount = std::max<size_t>(1, std::strtoul(argv[++index], nullptr, 10));
+		}
+		else if (!std::strcmp(argv[index], "--workers") && hasValue)
+		{
+			options.m_workerCount = unsigned(std::strtoul(argv[++index], nullptr, 10));
+		}
+		else
+		{
+			std::fprintf(stderr, "Unknown argument %s\n", argv[index]);
+			return false;
+		}
+	}
+	return true;
+}
+
+// Character counts of a scaling benchmark: counts up to --characters in increasing order and without duplicates, ending
+// with --characters itself
+std::vector<size_t> getCharacterCounts(Options const& options, std::vector<size_t> counts)
+{
+	std::erase_if(counts, [&](size_t count) { return count > options.m_characterCount; });
+	counts.push_back(options.m_characterCount);
+	std::sort(counts.begin(), counts.end());
+	counts.erase(std::unique(counts.begin(), counts.end()), counts.end());
+	return counts;
+}
+
+// Playback time of the given iteration, so the samplers do not keep hitting the same key
+double iterationTime(size_t iteration, Animation const& animation)
+{
+	return animation.m_Timing.wrapTime(iteration * double(FRAME_TIME));
+}
+
+void benchmarkMath(Suite& suite, Skeleton const& skeleton, std::vector<Transform> const& pose)
+{
+	size_t boneCount = skeleton.m_boneCount;
+
+	std::vector<Transform> transforms(pose);
+	std::vector<Transform> parents(boneCount);
+	for (size_t bone = 0; bone < boneCount; bone++)
+	{
+		parents[bone] = pose[(bone + 1) % boneCount];
+	}
+
+	suite.run("transform/compose", boneCount,
+			  [&](size_t)
+			  {
+				  for (size_t bone = 0; bone < boneCount; bone++)
+				  {
+					  transforms[bone] = pose[bone] * parents[bone];
+				  }
+				  keepAlive(transforms.data());
+			  });
+	suite.run("transform/compose_batch", boneCount,
+			  [&](size_t)
+			  {
+				  LM_::compose(getRigidTransforms(pose.data()), getRigidTransforms(parents.data()),
+							   getRigidTransforms(transforms.data()), boneCount);
+				  keepAlive(transforms.data());
+			  });
+	suite.run("transform/interpolate", boneCount,
+			  [&](size_t iteration)
+			  {
+				  float alpha = float(iteration % 16) / 16.f;
+				  for (size_t bone = 0; bone < boneCount; bone++)
+				  {
+					  transforms[bone] = interpolate(pose[bone], parents[bone], alpha);
+				  }
+				  keepAlive(transforms.data());
+			  });
+
+	std::vector<LM_::Quaternion> rotations(boneCount);
+	suite.run("quaternion/slerp", boneCount,
+			  [&](size_t iteration)
+			  {
+				  float alpha = float(iteration % 16) / 16.f;
+				  for (size_t bone = 0; bone < boneCount; bone++)
+				  {
+					  rotations[bone] = LM_::slerp(pose[bone].m_Rotation, parents[bone].m_Rotation, alpha);
+				  }
+				  keepAlive(rotations.data());
+			  });
+
+	std::vector<LM_::Mat4> matrices(boneCount);
+	std::vector<LM_::Mat4> results(boneCount);
+	suite.run("mat4/toRotationMat4", boneCount,
+			  [&](size_t)
+			  {
+				  for (size_t bone = 0; bone < boneCount; bone++)
+				  {
+					  matrices[bone] = LM_::toRotationMat4(pose[bone].m_Rotation);
+				  }
+				  keepAlive(matrices.data());
+			  });
+	suite.run("mat4/toAffineMat4_batch", boneCount,
+			  [&](size_t)
+			  {
+				  LM_::toAffineMat4(getRigidTransforms(pose.data()), matrices.data(), boneCount);
+				  keepAlive(matrices.data());
+			  });
+
+	std::vector<LM_::Mat4> parentMatrices(boneCount);
+	LM_::toAffineMat4(getRigidTransforms(parents.data()), parentMatrices.data(), boneCount);
+	suite.run("mat4/multiply", boneCount,
+			  [&](size_t)
+			  {
+				  for (size_t bone = 0; bone < boneCount; bone++)
+				  {
+					  results[bone] = parentMatrices[bone] * matrices[bone];
+				  }
+				  keepAlive(results.data());
+			  });
+	suite.run("mat4/multiply_batch", boneCount,
+			  [&](size_t)
+			  {
+				  LM_::multiply(parentMatrices.data(), matrices.data(), results.data(), boneCount);
+				  keepAlive(results.data());
+			  });
+	suite.run("mat4/GetInverse", boneCount,
+			  [&](size_t)
+			  {
+				  for (size_t bone = 0; bone < boneCount; bone++)
+				  {
+					  results[bone] = matrices[bone].GetInverse();
+				  }
+				  keepAlive(results.data());
+			  });
+	suite.run("mat4/GetRigidInverse", boneCount,
+			  [&](size_t)
+			  {
+				  for (size_t bone = 0; bone < boneCount; bone++)
+				  {
+					  results[bone] = matrices[bone].GetRigidInverse();
+				  }
+				  keepAlive(results.data());
+			  });
+	suite.run("mat4/invertRigid_batch", boneCount,
+			  [&](size_t)
+			  {
+				  LM_::invertRigid(matrices.data(), results.data(), boneCount);
+				  keepAlive(results.data());
+			  });
+}
+
+void benchmarkPose(Suite& suite, Options const& options, Skeleton const& skeleton, std::vector<Animation> const& animations)
+{
+	size_t			 boneCount = skeleton.m_boneCount;
+	Animation const& walk = animations[0];
+
+	std::vector<Transform> localPose(boneCount);
+	std::vector<Transform> modelPose(boneCount);
+	std::vector<LM_::Mat4> palette(boneCount);
+	KeyPairCache		   keyPairs(boneCount);
+
+	suite.run("pose/getPose", boneCount,
+			  [&](size_t iteration)
+			  {
+				  walk.getPose(iteration % walk.m_keyFrameCount, localPose.data());
+				  keepAlive(localPose.data());
+			  });
+	suite.run("pose/sample", boneCount,
+			  [&](size_t iteration) { keepAlive(keyPairs.sample(walk, iterationTime(iteration, walk)).data()); });
+	suite.run("pose/localToModel", boneCount,
+			  [&](size_t)
+			  {
+				  skeleton.localToModel(localPose.data(), modelPose.data());
+				  keepAlive(modelPose.data());
+			  });
+	suite.run("pose/skinningPalette", boneCount,
+			  [&](size_t)
+			  {
+				  skeleton.computeSkinningMatrices(modelPose.data(), palette.data());
+				  keepAlive(palette.data());
+			  });
+
+	std::vector<LM_::DualQuaternion> dualPalette(boneCount);
+	suite.run("pose/skinningPalette_dq", boneCount,
+			  [&](size_t)
+			  {
+				  skeleton.computeSkinningDualQuaternions(modelPose.data(), dualPalette.data());
+				  keepAlive(dualPalette.data());
+			  });
+
+	std::vector<LM_::AffineMat3x4> rowPalette(boneCount);
+	suite.run("pose/skinningPalette_3x4", boneCount,
+			  [&](size_t)
+			  {
+				  skeleton.computeSkinningMatrices(modelPose.data(), rowPalette.data());
+				  keepAlive(rowPalette.data());
+			  });
+
+	std::vector<LM_::HalfAffineMat3x4> halfRowPalette(boneCount);
+	suite.run("pose/skinningPalette_3x4h", boneCount,
+			  [&](size_t)
+			  {
+				  skeleton.computeSkinningMatrices(modelPose.data(), halfRowPalette.data());
+				  keepAlive(halfRowPalette.data());
+			  });
+
+	// Walk and run at half weight each, the phase sync and both samples included
+	FrameArena arena(65536);
+	BlendTree  tree(skeleton, animations);
+	int		   blendParameter = tree.addParameter(0.5f);
+	int		   syncGroup = tree.addSyncGroup();
+	int		   walkNode = tree.addClip(0, 1.f, syncGroup);
+	int		   runNode = tree.addClip(1, 1.f, syncGroup);
+	tree.addBlendSpace1D(blendParameter, { walkNode, runNode }, { 0.f, 1.f });
+	suite.run("pose/blend", boneCount,
+			  [&](size_t)
+			  {
+				  arena.reset();
+				  tree.evaluate(FRAME_TIME, arena, localPose);
+				  keepAlive(localPose.data());
+			  });
+
+	// Whole single character pipeline per character, what calculateTransforms and step4 do
+	std::vector<size_t> characterCounts;
+	for (size_t count = 1; count < options.m_characterCount; count *= 16)
+	{
+		characterCounts.push_back(count);
+	}
+
+	for (size_t characterCount : getCharacterCounts(options, characterCounts))
+	{
+		std::vector<KeyPairCache> caches(characterCount, KeyPairCache(boneCount));
+		std::string				  name = "characters/" + std::to_string(characterCount);
+		suite.run(name.c_str(), boneCount * characterCount,
+				  [&](size_t iteration)
+				  {
+					  for (size_t character = 0; character < characterCount; character++)
+					  {
+						  std::span<Transform const> pose = caches[character].sample(walk, iterationTime(iteration + character, walk));
+						  skeleton.localToModel(pose.data(), modelPose.data());
+						  skeleton.computeSkinningMatrices(modelPose.data(), palette.data());
+					  }
+					  keepAlive(palette.data());
+				  });
+	}
+}
+
+void benchmarkCrowd(Suite& suite, Options const& options, Skeleton const& skeleton, std::vector<Animation> const& animations)
+{
+	JobSystem jobSystem(options.m_workerCount);
+
+	std::vector<size_t> characterCounts = { 1, 16 };
+	for (size_t count = 128; count < options.m_characterCount; count *= 8)
+	{
+		characterCounts.push_back(count);
+	}
+
+	for (size_t characterCount : getCharacterCounts(options, characterCounts))
+	{
+		CharacterInstances crowd(skeleton, animations);
+		for (size_t character = 0; character < characterCount; character++)
+		{
+			int	   clipIndex = int(character % animations.size());
+			size_t instance = crowd.addInstance(clipIndex, character * 0.013);
+			crowd.setBlend(instance, (clipIndex + 1) % animations.size(), (character % 5) / 4.f);
+		}
+
+		std::string name = "crowd/" + std::to_string(characterCount);
+		suite.run(name.c_str(), skeleton.m_boneCount * characterCount,
+				  [&](size_t)
+				  {
+					  crowd.update(FRAME_TIME);
+					  crowd.evaluate(jobSystem);
+					  keepAlive(crowd.getSkinningMatrices().data());
+				  });
+	}
+}
+
+// The largest crowd of benchmarkCrowd at cheaper levels of detail, skeleton.m_Lods[1] and [2] leaving bones out
+void benchmarkCrowdLod(Suite& suite, Options const& options, Skeleton const& skeleton,
+					   std::vector<Animation> const& animations)
+{
+	JobSystem jobSystem(options.m_workerCount);
+
+	CharacterInstances crowd(skeleton, animations);
+	size_t			   characterCount = options.m_characterCount;
+	for (size_t character = 0; character < characterCount; character++)
+	{
+		int	   clipIndex = int(character % animations.size());
+		size_t instance = crowd.addInstance(clipIndex, character * 0.013);
+		crowd.setBlend(instance, (clipIndex + 1) % animations.size(), (character % 5) / 4.f);
+	}
+
+	auto run = [&](const char* name)
+	{
+		suite.run(name, skeleton.m_boneCount * characterCount,
+				  [&](size_t)
+				  {
+					  crowd.update(FRAME_TIME);
+					  crowd.evaluate(jobSystem);
+					  keepAlive(crowd.getSkinningMatrices().data());
+				  });
+	};
+
+	struct Uniform
+	{
+		const char* m_name;
+		int			m_skeletonLod;
+		int			m_updateInterval;
+	};
+	Uniform uniforms[] = { { "crowdLod/bones1", 1, 1 }, { "crowdLod/bones2", 2, 1 }, { "crowdLod/interval2", 0, 2 },
+						   { "crowdLod/interval4", 0, 4 }, { "crowdLod/bones2Interval4", 2, 4 } };
+	for (Uniform const& uniform : uniforms)
+	{
+		for (size_t instance = 0; instance < characterCount; instance++)
+		{
+			crowd.setLod(instance, uniform.m_skeletonLod, uniform.m_updateInterval);
+		}
+		run(uniform.m_name);
+	}
+
+	// Characters lined up away from the camera, 1.5m apart
+	AnimationLodScheduler scheduler({ { 0.5f, 0, 1 }, { 0.15f, 1, 1 }, { 0.05f, 1, 2 }, { 0.f, 2, 4 } });
+	std::vector<float>	  importances(characterCount);
+	for (size_t instance = 0; instance < characterCount; instance++)
+	{
+		importances[instance] = 180.f / (200.f + instance * 150.f);
+	}
+	scheduler.schedule(importances, crowd);
+	run("crowdLod/scheduled");
+}
+
+// Skins the mesh with one palette, on the calling thread with each instruction set then over the workers
+template<class Palette>
+void benchmarkSkinning(Suite& suite, std::string const& prefix, JobSystem& jobSystem, SkinnedMesh& mesh,
+					   std::vector<Palette> const& palette)
+{
+	size_t vertexCount = mesh.getVertexCount();
+
+	const char*	   levelNames[] = { "scalar", "sse", "avx2" };
+	LM_::SimdLevel supportedLevel = LM_::getSupportedSimdLevel();
+	for (int level = 0; level <= int(supportedLevel); level++)
+	{
+		LM_::setSimdLevel(LM_::SimdLevel(level));
+		suite.run((prefix + levelNames[level]).c_str(), VERTICES, vertexCount,
+				  [&](size_t)
+				  {
+					  mesh.skin(std::span<Palette const>(palette), 0, vertexCount);
+					  keepAlive(&mesh);
+				  });
+	}
+	LM_::setSimdLevel(supportedLevel);
+
+	suite.run((prefix + "jobs/" + std::to_string(jobSystem.getWorkerCount())).c_str(), VERTICES, vertexCount,
+			  [&](size_t)
+			  {
+				  mesh.skin(std::span<Palette const>(palette), jobSystem);
+				  keepAlive(&mesh);
+			  });
+}
+
+// Skins the mannequin with a walk pose, with blended matrices then with blended dual quaternions.
+// Also builds the palettes of its sections, which only hold the bones the mesh references.
+void benchmarkSkinning(Suite& suite, Options const& options, Skeleton const& skeleton, std::vector<Transform> const& pose)
+{
+	MeshFile file((std::string(RESOURCE_DIR) + "SK_Mannequin.msh").c_str());
+	file.remapBones(skeleton.m_sourceToBone);
+
+	SkinnedMesh	  mesh(file);
+	MeshBoneRemap remap(file);
+	JobSystem	  jobSystem(options.m_workerCount);
+
+	std::vector<Transform>			 modelPose(skeleton.m_boneCount);
+	std::vector<LM_::Mat4>			 palette(skeleton.m_boneCount);
+	std::vector<LM_::DualQuaternion> dualPalette(skeleton.m_boneCount);
+	skeleton.localToModel(pose.data(), modelPose.data());
+	skeleton.computeSkinningMatrices(modelPose.data(), palette.data());
+	skeleton.computeSkinningDualQuaternions(modelPose.data(), dualPalette.data());
+
+	suite.run("skinning/sectionPalettes", remap.getPaletteSize(),
+			  [&](size_t)
+			  {
+				  for (MeshSection const& section : remap.getSections())
+				  {
+					  skeleton.computeSkinningMatrices(modelPose.data(), section.m_Bones, palette.data());
+				  }
+				  keepAlive(palette.data());
+			  });
+
+	skeleton.computeSkinningMatrices(modelPose.data(), palette.data());
+	benchmarkSkinning(suite, "skinning/", jobSystem, mesh, palette);
+	benchmarkSkinning(suite, "skinning/dq_", jobSystem, mesh, dualPalette);
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!parseOptions(argc, argv, options))
+	{
+		return EXIT_FAILURE;
+	}
+
+	Skeleton skeleton(GetSkeletonBoneCount());
+	size_t	 boneCount = skeleton.m_boneCount;
+
+	std::vector<Transform> bindPose(boneCount);
+	for (size_t bone = 0; bone < boneCount; bone++)
+	{
+		bindPose[bone] = skeleton.m_Bones[bone].m_localTransform;
+	}
+	skeleton.m_inverseBindTransforms.resize(boneCount);
+	skeleton.localToModel(bindPose.data(), skeleton.m_inverseBindTransforms.data());
+	LM_::invert(getRigidTransforms(skeleton.m_inverseBindTransforms.data()),
+				getRigidTransforms(skeleton.m_inverseBindTransforms.data()), boneCount);
+	skeleton.m_inverseBindPoses.resize(boneCount);
+	LM_::toAffineMat4(getRigidTransforms(skeleton.m_inverseBindTransforms.data()), skeleton.m_inverseBindPoses.data(),
+					  boneCount);
+
+	const char*				 animNames[] = { "ThirdPersonWalk.anim", "ThirdPersonRun.anim" };
+	std::vector<std::string> animPaths;
+	for (const char* animName : animNames)
+	{
+		animPaths.push_back(std::string(RESOURCE_DIR) + animName);
+	}
+
+	std::vector<AnimationFile> animFiles = loadAnimationFiles(animPaths);
+	std::vector<Animation>	   animations;
+	animations.reserve(animFiles.size());
+	for (size_t index = 0; index < animFiles.size(); index++)
+	{
+		animations.emplace_back(animNames[index], AnimationClip(animFiles[index], skeleton));
+	}
+
+	std::vector<Transform> walkPose(boneCount);
+	animations[0].getPose(0, walkPose.data());
+
+	const char* smallBones[] = { "index_", "middle_", "pinky_", "ring_", "thumb_", "twist_" };
+	const char* farBones[] = { "index_", "middle_", "pinky_", "ring_", "thumb_", "twist_", "ball_" };
+	skeleton.addLod(smallBones);
+	skeleton.addLod(farBones, 6);
+
+	Suite suite(options);
+	benchmarkMath(suite, skeleton, walkPose);
+	benchmarkPose(suite, options, skeleton, animations);
+	benchmarkCrowd(suite, options, skeleton, animations);
+	benchmarkCrowdLod(suite, options, skeleton, animations);
+	benchmarkSkinning(suite, options, skeleton, walkPose);
+
+	if (options.m_jsonPath != nullptr && !suite.writeJson(options.m_jsonPath))
+	{
+		std::fprintf(stderr, "Cannot write %s\n", options.m_jsonPath);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
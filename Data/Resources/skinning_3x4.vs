@@ -0,0 +1,56 @@
+
+/////////////////////
+// INPUT VARIABLES //
+/////////////////////
+in lowp vec3 inputPosition;
+in lowp vec3 normal;
+in lowp vec4 boneIndices;
+in lowp vec4 boneWeights;
+
+//////////////////////
+// OUTPUT VARIABLES //
+//////////////////////
+smooth out vec2 texCoord;
+smooth out vec3 outNormal;
+
+uniform SceneMatrices
+{
+	uniform mat4 projectionMatrix;
+} sm;
+
+uniform mat4 modelViewMatrix;
+
+// Same buffer as skinning.vs, filled with the first three rows of the matrices:
+// rows[3 * bone + i] is row i, three rotation elements followed by a translation element
+uniform SkinningMatrices
+{
+	uniform vec4 rows[192];
+} skin;
+
+
+
+mat3x4 boneRows(int bone)
+{
+	return mat3x4(skin.rows[3 * bone], skin.rows[3 * bone + 1], skin.rows[3 * bone + 2]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Vertex Shader
+////////////////////////////////////////////////////////////////////////////////
+void main(void)
+{
+	float scalar = 1.0 / (boneWeights.x + boneWeights.y + boneWeights.z + boneWeights.w);
+
+	mat3x4 result = (scalar * boneWeights.w) * boneRows(int(boneIndices.w))
+				  + (scalar * boneWeights.z) * boneRows(int(boneIndices.z))
+				  + (scalar * boneWeights.y) * boneRows(int(boneIndices.y))
+				  + (scalar * boneWeights.x) * boneRows(int(boneIndices.x));
+
+	// The columns of result are the rows of the skinning matrix
+	vec3 position = vec4(inputPosition, 1.0f) * result;
+
+	gl_Position = sm.projectionMatrix * (modelViewMatrix * vec4(position, 1.0f));
+	outNormal = mat3(modelViewMatrix) * (vec4(normal, 0.0f) * result);
+
+	outNormal = normalize(outNormal);
+}
@@ -0,0 +1,63 @@
+
+/////////////////////
+// INPUT VARIABLES //
+/////////////////////
+in lowp vec3 inputPosition;
+in lowp vec3 normal;
+in lowp vec4 boneIndices;
+in lowp vec4 boneWeights;
+
+//////////////////////
+// OUTPUT VARIABLES //
+//////////////////////
+smooth out vec2 texCoord;
+smooth out vec3 outNormal;
+
+uniform SceneMatrices
+{
+	uniform mat4 projectionMatrix;
+} sm;
+
+uniform mat4 modelViewMatrix;
+
+// Same buffer as skinning.vs, filled with the rows of skinning_3x4.vs as half floats: 6 uints per bone, two halves
+// each, the first element in the low bits. unpackHalf2x16 needs GLSL 4.20 or ES 3.00.
+uniform SkinningMatrices
+{
+	uniform uvec4 halves[256];
+} skin;
+
+
+
+vec4 boneRow(int bone, int row)
+{
+	int first = 6 * bone + 2 * row;
+	int second = first + 1;
+	return vec4(unpackHalf2x16(skin.halves[first >> 2][first & 3]), unpackHalf2x16(skin.halves[second >> 2][second & 3]));
+}
+
+mat3x4 boneRows(int bone)
+{
+	return mat3x4(boneRow(bone, 0), boneRow(bone, 1), boneRow(bone, 2));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Vertex Shader
+////////////////////////////////////////////////////////////////////////////////
+void main(void)
+{
+	float scalar = 1.0 / (boneWeights.x + boneWeights.y + boneWeights.z + boneWeights.w);
+
+	mat3x4 result = (scalar * boneWeights.w) * boneRows(int(boneIndices.w))
+				  + (scalar * boneWeights.z) * boneRows(int(boneIndices.z))
+				  + (scalar * boneWeights.y) * boneRows(int(boneIndices.y))
+				  + (scalar * boneWeights.x) * boneRows(int(boneIndices.x));
+
+	// The columns of result are the rows of the skinning matrix
+	vec3 position = vec4(inputPosition, 1.0f) * result;
+
+	gl_Position = sm.projectionMatrix * (modelViewMatrix * vec4(position, 1.0f));
+	outNormal = mat3(modelViewMatrix) * (vec4(normal, 0.0f) * result);
+
+	outNormal = normalize(outNormal);
+}
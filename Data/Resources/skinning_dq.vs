@@ -0,0 +1,75 @@
+
+/////////////////////
+// INPUT VARIABLES //
+/////////////////////
+in lowp vec3 inputPosition;
+in lowp vec3 normal;
+in lowp vec4 boneIndices;
+in lowp vec4 boneWeights;
+
+//////////////////////
+// OUTPUT VARIABLES //
+//////////////////////
+smooth out vec2 texCoord;
+smooth out vec3 outNormal;
+
+uniform SceneMatrices
+{
+	uniform mat4 projectionMatrix;
+} sm;
+
+uniform mat4 modelViewMatrix;
+
+// Same buffer as skinning.vs, filled with dual quaternions instead of matrices:
+// dq[2 * bone] is the rotation and dq[2 * bone + 1] the dual part, both stored w, x, y, z
+uniform SkinningMatrices
+{
+	uniform vec4 dq[128];
+} skin;
+
+
+
+// Weighted dual quaternion of one influence, flipped to the hemisphere of the first one
+void blendInfluence(float weight, int bone, vec4 pivot, inout vec4 real, inout vec4 dual)
+{
+	vec4 boneReal = skin.dq[2 * bone];
+	if (dot(boneReal, pivot) < 0.0)
+	{
+		weight = -weight;
+	}
+
+	real += weight * boneReal;
+	dual += weight * skin.dq[2 * bone + 1];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Vertex Shader
+////////////////////////////////////////////////////////////////////////////////
+void main(void)
+{
+	float scalar = 1.0 / (boneWeights.x + boneWeights.y + boneWeights.z + boneWeights.w);
+
+	vec4 pivot = skin.dq[2 * int(boneIndices.x)];
+	vec4 real = vec4(0.0);
+	vec4 dual = vec4(0.0);
+
+	blendInfluence(scalar * boneWeights.x, int(boneIndices.x), pivot, real, dual);
+	blendInfluence(scalar * boneWeights.y, int(boneIndices.y), pivot, real, dual);
+	blendInfluence(scalar * boneWeights.z, int(boneIndices.z), pivot, real, dual);
+	blendInfluence(scalar * boneWeights.w, int(boneIndices.w), pivot, real, dual);
+
+	float inverseLength = 1.0 / length(real);
+	real *= inverseLength;
+	dual *= inverseLength;
+
+	// Rotation by real, then translation by 2 * dual * conjugate(real)
+	vec3 position = inputPosition + 2.0 * cross(real.yzw, cross(real.yzw, inputPosition) + real.x * inputPosition);
+	position += 2.0 * (real.x * dual.yzw - dual.x * real.yzw + cross(real.yzw, dual.yzw));
+
+	gl_Position = sm.projectionMatrix * (modelViewMatrix * vec4(position, 1.0f));
+
+	vec3 skinnedNormal = normal + 2.0 * cross(real.yzw, cross(real.yzw, normal) + real.x * normal);
+	outNormal = mat3(modelViewMatrix) * skinnedNormal;
+
+	outNormal = normalize(outNormal);
+}
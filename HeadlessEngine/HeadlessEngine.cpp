@@ -0,0 +1,403 @@
+#include "HeadlessEngine.h"
+#include "Simulation.h"
+
+#include "SkeletonFile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+
+namespace
+{
+HeadlessSettings g_Settings;
+
+// Bind pose of a bone relative to its parent (rotation is w, x, y, z)
+struct LocalBindTransform
+{
+	float m_position[3];
+	float m_rotation[4];
+};
+
+std::unique_ptr<SkeletonFile>		 g_Skeleton;
+std::vector<LocalBindTransform>		 g_LocalBindTransforms;
+std::map<std::string, AnimationFile> g_Animations;
+
+std::vector<float>						g_skinningPose;
+size_t									g_skinningPoseBoneCount = 0;
+std::vector<std::vector<unsigned char>>	g_SkinningPalettes; // One per section
+std::vector<HeadlessLine>				g_Lines;
+std::vector<HeadlessFrameStats>			g_FrameStats;
+HeadlessFrameStats						g_currentFrame;
+int										g_exitCode = 0;
+
+std::atomic<size_t> g_allocationCount = 0;
+
+std::string resourcePath(const char* name)
+{
+	return std::string(g_Settings.m_resourceDirectory) + name;
+}
+
+// a * b for w, x, y, z quaternions
+void multiplyQuaternions(float const (&a)[4], float const (&b)[4], float (&result)[4])
+{
+	result[0] = a[0] * b[0] - a[1] * b[1] - a[2] * b[2] - a[3] * b[3];
+	result[1] = a[0] * b[1] + a[1] * b[0] + a[2] * b[3] - a[3] * b[2];
+	result[2] = a[0] * b[2] + a[2] * b[0] + a[3] * b[1] - a[1] * b[3];
+	result[3] = a[0] * b[3] + a[3] * b[0] + a[1] * b[2] - a[2] * b[1];
+}
+
+// The .skel file stores model space bind transforms while the engine hands out parent relative ones:
+// local = inverse(parent) * model
+std::vector<LocalBindTransform> toLocalBindTransforms(SkeletonFile const& skeletonFile)
+{
+	std::vector<LocalBindTransform> transforms(skeletonFile.m_Bones.size());
+	for (size_t index = 0; index < transforms.size(); index++)
+	{
+		SkeletonFileBone const& bone = skeletonFile.m_Bones[index];
+		LocalBindTransform&		transform = transforms[index];
+
+		if (bone.m_parentIndex < 0)
+		{
+			std::copy(bone.m_position, bone.m_position + 3, transform.m_position);
+			std::copy(bone.m_rotation, bone.m_rotation + 4, transform.m_rotation);
+			continue;
+		}
+
+		SkeletonFileBone const& parent = skeletonFile.m_Bones[bone.m_parentIndex];
+		float const				inverseParent[4] = { parent.m_rotation[0], -parent.m_rotation[1], -parent.m_rotation[2],
+													 -parent.m_rotation[3] };
+		float const				offset[4] = { 0.f, bone.m_position[0] - parent.m_position[0],
+											  bone.m_position[1] - parent.m_position[1], bone.m_position[2] - parent.m_position[2] };
+
+		float rotated[4];
+		float halfRotated[4];
+		multiplyQuaternions(inverseParent, offset, halfRotated);
+		multiplyQuaternions(halfRotated, parent.m_rotation, rotated);
+		std::copy(rotated + 1, rotated + 4, transform.m_position);
+
+		multiplyQuaternions(inverseParent, bone.m_rotation, transform.m_rotation);
+	}
+	return transforms;
+}
+
+SkeletonFile const& skeleton()
+{
+	if (!g_Skeleton)
+	{
+		g_Skeleton = std::make_unique<SkeletonFile>(resourcePath(g_Settings.m_skeletonName).c_str());
+		g_LocalBindTransforms = toLocalBindTransforms(*g_Skeleton);
+	}
+	return *g_Skeleton;
+}
+
+AnimationFile const& animation(const char* animName)
+{
+	auto found = g_Animations.find(animName);
+	if (found == g_Animations.end())
+	{
+		found = g_Animations.emplace(animName, AnimationFile(resourcePath(animName).c_str())).first;
+	}
+	return found->second;
+}
+} // namespace
+
+/* HEADLESS API */
+
+void HeadlessSetSettings(HeadlessSettings const& settings)
+{
+	g_Settings = settings;
+	g_Skeleton.reset();
+	g_Animations.clear();
+}
+
+HeadlessSettings const& HeadlessGetSettings()
+{
+	return g_Settings;
+}
+
+void HeadlessParseArguments(int argc, char** argv)
+{
+	HeadlessSettings settings = g_Settings;
+
+	for (int index = 1; index < argc; index++)
+	{
+		bool hasValue = index + 1 < argc;
+
+		if (!strcmp(argv[index], "--frames") && hasValue)
+		{
+			settings.m_frameCount = unsigned(std::strtoul(argv[++index], nullptr, 10));
+		}
+		else if (!strcmp(argv[index], "--tick") && hasValue)
+		{
+			settings.m_fixedFrameTime = std::strtof(argv[++index], nullptr);
+		}
+		else if (!strcmp(argv[index], "--resources") && hasValue)
+		{
+			settings.m_resourceDirectory = argv[++index];
+		}
+		else if (!strcmp(argv[index], "--skeleton") && hasValue)
+		{
+			settings.m_skeletonName = argv[++index];
+		}
+		else if (!strcmp(argv[index], "--check-allocations"))
+		{
+			settings.m_checkAllocations = true;
+		}
+		else if (!strcmp(argv[index], "--quiet"))
+		{
+			settings.m_verbose = false;
+		}
+		else
+		{
+			std::cerr << "Unknown headless argument " << argv[index] << std::endl;
+		}
+	}
+
+	HeadlessSetSettings(settings);
+}
+
+std::vector<float> const& HeadlessGetSkinningPose()
+{
+	return g_skinningPose;
+}
+
+size_t HeadlessGetSkinningPoseBoneCount()
+{
+	return g_skinningPoseBoneCount;
+}
+
+std::vector<unsigned char> const& HeadlessGetSkinningPalette(size_t section)
+{
+	static std::vector<unsigned char> const none;
+	return section < g_SkinningPalettes.size() ? g_SkinningPalettes[section] : none;
+}
+
+std::vector<HeadlessLine> const& HeadlessGetLines()
+{
+	return g_Lines;
+}
+
+std::vector<HeadlessFrameStats> const& HeadlessGetFrameStats()
+{
+	return g_FrameStats;
+}
+
+int HeadlessGetExitCode()
+{
+	return g_exitCode;
+}
+
+/* ENGINE API */
+
+void Run(ISimulation* pSimulation, unsigned int width, unsigned int height)
+{
+	using Clock = std::chrono::steady_clock;
+
+	(void)width;
+	(void)height;
+
+	g_FrameStats.clear();
+	g_FrameStats.reserve(g_Settings.m_frameCount);
+	g_exitCode = 0;
+
+	pSimulation->Init();
+
+	float  frameTime = g_Settings.m_fixedFrameTime > 0.f ? g_Settings.m_fixedFrameTime : 0.f;
+	double totalMilliseconds = 0.0;
+	double worstMilliseconds = 0.0;
+	size_t steadyAllocationCount = 0;
+
+	for (unsigned int frame = 0; frame < g_Settings.m_frameCount; frame++)
+	{
+		g_Lines.clear();
+		g_currentFrame = HeadlessFrameStats();
+		g_currentFrame.m_frameIndex = frame;
+
+		size_t			  allocationCount = g_allocationCount;
+		Clock::time_point start = Clock::now();
+		pSimulation->Update(frameTime);
+		Clock::time_point end = Clock::now();
+
+		g_currentFrame.m_allocationCount = g_allocationCount - allocationCount;
+		if (frame > 0)
+		{
+			steadyAllocationCount += g_currentFrame.m_allocationCount;
+		}
+
+		g_currentFrame.m_updateMilliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+		g_currentFrame.m_lineCount = g_Lines.size();
+		g_FrameStats.push_back(g_currentFrame);
+
+		totalMilliseconds += g_currentFrame.m_updateMilliseconds;
+		worstMilliseconds = std::max(worstMilliseconds, g_currentFrame.m_updateMilliseconds);
+
+		if (g_Settings.m_fixedFrameTime <= 0.f)
+		{
+			frameTime = float(g_currentFrame.m_updateMilliseconds / 1000.0);
+		}
+	}
+
+	if (g_Settings.m_verbose && g_Settings.m_frameCount > 0)
+	{
+		std::cout << "Headless run: " << g_Settings.m_frameCount << " frames, "
+				  << totalMilliseconds / g_Settings.m_frameCount << " ms/update (worst " << worstMilliseconds
+				  << " ms), last frame " << g_FrameStats.back().m_skinningPoseBones << " bones in "
+				  << g_FrameStats.back().m_skinningPoseBytes << " bytes, " << g_Lines.size() << " lines, "
+				  << steadyAllocationCount << " allocations after the first frame" << std::endl;
+	}
+
+	if (g_Settings.m_checkAllocations && steadyAllocationCount > 0)
+	{
+		std::cerr << "Allocation check failed: " << steadyAllocationCount << " heap allocations after the first frame"
+				  << std::endl;
+		g_exitCode = EXIT_FAILURE;
+	}
+}
+
+void SetSkinningPose(const float* boneMatrices, size_t boneCount)
+{
+	g_skinningPose.assign(boneMatrices, boneMatrices + boneCount * 16);
+	g_skinningPoseBoneCount = boneCount;
+	g_currentFrame.m_skinningPoseCount++;
+	g_currentFrame.m_skinningPoseBones += boneCount;
+	g_currentFrame.m_skinningPoseBytes += boneCount * 16 * sizeof(float);
+}
+
+void HeadlessSetSkinningPalette(void const* palette, size_t byteCount, size_t boneCount, size_t section)
+{
+	if (section >= g_SkinningPalettes.size())
+	{
+		g_SkinningPalettes.resize(section + 1);
+	}
+
+	unsigned char const* bytes = static_cast<unsigned char const*>(palette);
+	g_SkinningPalettes[section].assign(bytes, bytes + byteCount);
+	g_skinningPoseBoneCount = boneCount;
+	g_currentFrame.m_skinningPoseCount++;
+	g_currentFrame.m_skinningPoseBones += boneCount;
+	g_currentFrame.m_skinningPoseBytes += byteCount;
+}
+
+size_t GetSkeletonBoneCount()
+{
+	return skeleton().m_Bones.size();
+}
+
+const char* GetSkeletonBoneName(int boneIndex)
+{
+	return skeleton().m_Bones[boneIndex].m_Name.c_str();
+}
+
+int GetSkeletonBoneIndex(const char* name)
+{
+	return skeleton().findBone(name);
+}
+
+int GetSkeletonBoneParentIndex(int boneIndex)
+{
+	return skeleton().m_Bones[boneIndex].m_parentIndex;
+}
+
+void GetSkeletonBoneLocalBindTransform(
+	int boneIndex, float& posX, float& posY, float& posZ, float& quatW, float& quatX, float& quatY, float& quatZ)
+{
+	skeleton();
+	LocalBindTransform const& transform = g_LocalBindTransforms[boneIndex];
+
+	posX = transform.m_position[0];
+	posY = transform.m_position[1];
+	posZ = transform.m_position[2];
+	quatW = transform.m_rotation[0];
+	quatX = transform.m_rotation[1];
+	quatY = transform.m_rotation[2];
+	quatZ = transform.m_rotation[3];
+}
+
+size_t GetAnimKeyCount(const char* animName)
+{
+	return animation(animName).m_keyCount;
+}
+
+void GetAnimLocalBoneTransform(
+	const char* animName, int boneIndex, int keyFrameIndex, float& posX, float& posY, float& posZ, float& quatW, float& quatX,
+	float& quatY, float& quatZ)
+{
+	AnimationFileKey const& key = animation(animName).getKey(boneIndex, keyFrameIndex);
+
+	posX = key.m_position[0];
+	posY = key.m_position[1];
+	posZ = key.m_position[2];
+	quatW = key.m_rotation[0];
+	quatX = key.m_rotation[1];
+	quatY = key.m_rotation[2];
+	quatZ = key.m_rotation[3];
+}
+
+void DrawLine(float x0, float y0, float z0, float x1, float y1, float z1, float r, float g, float b)
+{
+	g_Lines.push_back({ { x0, y0, z0 }, { x1, y1, z1 }, { r, g, b } });
+}
+
+/* ALLOCATION COUNTING */
+
+// Every sized, array and nothrow form of new ends up in this one
+void* operator new(size_t size)
+{
+	g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	if (void* memory = std::malloc(size > 0 ? size : 1))
+	{
+		return memory;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	std::free(memory);
+}
+
+// Same for the over-aligned forms, which AnimationClip buffers use
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	size_t alignmentSize = static_cast<size_t>(alignment);
+	size_t alignedSize = (std::max<size_t>(size, 1) + alignmentSize - 1) / alignmentSize * alignmentSize;
+#ifdef _MSC_VER
+	void* memory = _aligned_malloc(alignedSize, alignmentSize);
+#else
+	void* memory = std::aligned_alloc(alignmentSize, alignedSize);
+#endif
+	if (memory != nullptr)
+	{
+		return memory;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+#ifdef _MSC_VER
+	_aligned_free(memory);
+#else
+	std::free(memory);
+#endif
+}
+
+void operator delete(void* memory, size_t, std::align_val_t alignment) noexcept
+{
+	operator delete(memory, alignment);
+}
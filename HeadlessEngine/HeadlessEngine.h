@@ -0,0 +1,66 @@
+#ifndef __HEADLESS_ENGINE_H__
+#define __HEADLESS_ENGINE_H__
+
+#include "AnimationFile.h"
+#include "Engine.h"
+
+#include <vector>
+
+// Stand-in for Engine.dll: implements every entry point of Engine.h without window nor GPU.
+// Resources are parsed straight from the .skel/.anim files, SetSkinningPose and DrawLine are recorded
+// into buffers and Run drives ISimulation::Update at a fixed (or unlocked) tick.
+
+struct HeadlessSettings
+{
+	unsigned int m_frameCount = 600;
+	// Frame time sent to ISimulation::Update, 0 means unlocked (measured wall-clock time of the previous frame)
+	float		 m_fixedFrameTime = 1.f / 60.f;
+	const char*	 m_resourceDirectory = RESOURCE_DIR;
+	const char*	 m_skeletonName = "ThirdPersonWalk.skel";
+	bool		 m_verbose = true;
+	// Fails the run (see HeadlessGetExitCode) if any Update but the first one allocates from the heap
+	bool		 m_checkAllocations = false;
+};
+
+// One line sent through DrawLine: start, end and color
+struct HeadlessLine
+{
+	float m_start[3];
+	float m_end[3];
+	float m_color[3];
+};
+
+struct HeadlessFrameStats
+{
+	unsigned int m_frameIndex = 0;
+	double		 m_updateMilliseconds = 0.0;
+	size_t		 m_skinningPoseCount = 0;
+	size_t		 m_skinningPoseBones = 0; // Sent through SetSkinningPose and HeadlessSetSkinningPalette
+	size_t		 m_skinningPoseBytes = 0;
+	size_t		 m_lineCount = 0;
+	size_t		 m_allocationCount = 0; // operator new calls made during Update, from any thread
+};
+
+void HeadlessSetSettings(HeadlessSettings const& settings);
+HeadlessSettings const& HeadlessGetSettings();
+
+// Reads --frames N, --tick SECONDS (0 = unlocked), --resources DIRECTORY/, --skeleton NAME, --check-allocations and --quiet
+void HeadlessParseArguments(int argc, char** argv);
+
+// Size aware SetSkinningPose for palettes that are not made of Mat4: byteCount bytes of any layout for boneCount bones,
+// the layout of the shader drawing them. A mesh split in sections sends one palette per section, each section keeps
+// its last one. Engine.dll has no such entry point, the matrices of SetSkinningPose carry the bytes there.
+void HeadlessSetSkinningPalette(void const* palette, size_t byteCount, size_t boneCount, size_t section = 0);
+
+// Buffers of the last completed frame
+std::vector<float> const&		  HeadlessGetSkinningPose();
+size_t							  HeadlessGetSkinningPoseBoneCount();
+std::vector<unsigned char> const& HeadlessGetSkinningPalette(size_t section = 0);
+std::vector<HeadlessLine> const&  HeadlessGetLines();
+
+std::vector<HeadlessFrameStats> const& HeadlessGetFrameStats();
+
+// Process exit code of the last Run: non zero if one of its checks failed
+int HeadlessGetExitCode();
+
+#endif
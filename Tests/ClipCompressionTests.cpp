@@ -0,0 +1,111 @@
+// Compresses the clips of the project at a few error thresholds and checks that no bone of the decompressed poses
+// moves further than the threshold from the original one in model space, and that the clips got smaller. The
+// thresholds stay above the floor of the 16-bit quantization. Each compressed clip then goes through a clip cache, whose
+// mapped copy has to decompress to the same poses. Returns EXIT_FAILURE if any check fails.
+#include "AnimationClip.h"
+#include "AnimationFile.h"
+#include "ClipCache.h"
+#include "CompressedClip.h"
+#include "Engine.h"
+#include "Skeleton.h"
+#include "Transform.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace
+{
+// Largest distance between the model positions of a bone in the original and the decompressed poses
+float maxBoneError(AnimationClip const& clip, CompressedClip const& compressed, Skeleton const& skeleton)
+{
+	size_t				   boneCount = skeleton.m_boneCount;
+	std::vector<Transform> originalPose(boneCount);
+	std::vector<Transform> compressedPose(boneCount);
+	std::vector<Transform> originalModelPose(boneCount);
+	std::vector<Transform> compressedModelPose(boneCount);
+
+	float error = 0.f;
+	for (size_t key = 0; key < clip.getKeyCount(); key++)
+	{
+		for (size_t bone = 0; bone < boneCount; bone++)
+		{
+			originalPose[bone] = clip.getTransform(bone, key);
+		}
+		compressed.getPose(key, compressedPose.data());
+		skeleton.localToModel(originalPose.data(), originalModelPose.data());
+		skeleton.localToModel(compressedPose.data(), compressedModelPose.data());
+
+		for (size_t bone = 0; bone < boneCount; bone++)
+		{
+			error = std::max(error, (originalModelPose[bone].m_Position - compressedModelPose[bone].m_Position).magnitude());
+		}
+	}
+	return error;
+}
+
+// Bakes compressed into a cache file next to the system temporaries, maps it back and compares every pose, bit for bit
+bool isSameOnceCached(std::string const& animPath, CompressedClip const& compressed, Skeleton const& skeleton, float errorThreshold)
+{
+	std::string cachePath = (std::filesystem::temp_directory_path() / "ClipCompressionTests.clipcache").string();
+	std::string skelPath = getSkeletonPath(animPath);
+	writeClipCache(cachePath, animPath, skelPath, skeleton, compressed, errorThreshold);
+
+	bool isSame = isClipCacheUpToDate(cachePath, animPath, skelPath, skeleton, errorThreshold) &&
+		!isClipCacheUpToDate(cachePath, animPath, skelPath, skeleton);
+	{
+		CompressedClip		   mapped = mapCompressedClipCache(cachePath);
+		std::vector<Transform> pose(skeleton.m_boneCount);
+		std::vector<Transform> mappedPose(skeleton.m_boneCount);
+		isSame = isSame && mapped.getKeyCount() == compressed.getKeyCount() && mapped.getMemorySize() == compressed.getMemorySize();
+		for (size_t key = 0; isSame && key < compressed.getKeyCount(); key++)
+		{
+			compressed.getPose(key, pose.data());
+			mapped.getPose(key, mappedPose.data());
+			isSame = memcmp(pose.data(), mappedPose.data(), pose.size() * sizeof(Transform)) == 0;
+		}
+	}
+
+	std::filesystem::remove(cachePath);
+	return isSame;
+}
+} // namespace
+
+int main()
+{
+	Skeleton skeleton(GetSkeletonBoneCount());
+
+	const char*				 animNames[] = { "ThirdPersonWalk.anim", "ThirdPersonRun.anim" };
+	std::vector<std::string> animPaths;
+	for (const char* animName : animNames)
+	{
+		animPaths.push_back(std::string(RESOURCE_DIR) + animName);
+	}
+	std::vector<AnimationFile> animFiles = loadAnimationFiles(animPaths);
+
+	int failureCount = 0;
+	for (size_t index = 0; index < animFiles.size(); index++)
+	{
+		AnimationClip clip(animFiles[index], skeleton);
+		for (float errorThreshold : { 0.05f, 0.1f, 1.f })
+		{
+			CompressedClip compressed(clip, skeleton, errorThreshold);
+			float		   error = maxBoneError(clip, compressed, skeleton);
+			bool		   isBounded = error <= errorThreshold;
+			bool		   isSmaller = compressed.getMemorySize() < clip.getMemorySize();
+			bool		   isCached = isSameOnceCached(animPaths[index], compressed, skeleton, errorThreshold);
+
+			std::printf("%s %s at %g: max error %g, %zu -> %zu bytes%s\n", isBounded && isSmaller && isCached ? "OK" : "FAILED",
+						animNames[index], errorThreshold, error, clip.getMemorySize(), compressed.getMemorySize(),
+						isCached ? "" : ", cached copy differs");
+			failureCount += !isBounded || !isSmaller || !isCached;
+		}
+	}
+
+	std::printf("%d failed checks\n", failureCount);
+	return failureCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
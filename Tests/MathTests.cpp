@@ -0,0 +1,322 @@
+// Checks the LibMath batch functions on every instruction set the CPU supports: Mat4 inverses, dual quaternion
+// skinning against matrix skinning, and half float conversions. Returns EXIT_FAILURE if any check fails.
+#include "LibMath/Batch.h"
+#include "LibMath/Quaternion.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace LM_ = LibMath;
+
+namespace
+{
+const char* g_levelNames[] = { "scalar", "SSE", "AVX2" };
+int			g_failureCount = 0;
+
+void check(bool condition, const char* test, LM_::SimdLevel level, double value)
+{
+	if (!condition)
+	{
+		std::printf("FAILED %s (%s): %g\n", test, g_levelNames[int(level)], value);
+		g_failureCount++;
+	}
+}
+
+// Largest element of matrix * inverse - identity, computed in double
+double maxResidual(std::vector<LM_::Mat4> const& matrices, std::vector<LM_::Mat4> const& inverses)
+{
+	double residual = 0.0;
+	for (size_t index = 0; index < matrices.size(); index++)
+	{
+		for (int column = 0; column < 4; column++)
+		{
+			for (int row = 0; row < 4; row++)
+			{
+				double element = column == row ? -1.0 : 0.0;
+				for (int k = 0; k < 4; k++)
+				{
+					element += double(matrices[index][k][row]) * inverses[index][column][k];
+				}
+				residual = std::max(residual, std::fabs(element));
+			}
+		}
+	}
+	return residual;
+}
+
+LM_::Quaternion randomRotation(std::mt19937& random)
+{
+	std::uniform_real_distribution<float> unit(-1.f, 1.f);
+	LM_::Quaternion						  rotation(unit(random), unit(random), unit(random), unit(random) + 2.f);
+	return rotation.toUnitQuaternion();
+}
+
+void checkInverses(LM_::SimdLevel level)
+{
+	std::mt19937						  random(42);
+	std::uniform_real_distribution<float> unit(-1.f, 1.f);
+
+	std::vector<LM_::Mat4> rigid, affine, general;
+	for (int index = 0; index < 1024; index++)
+	{
+		LM_::Vec3 translation(unit(random) * 100.f, unit(random) * 100.f, unit(random) * 100.f);
+		rigid.push_back(LM_::toAffineMat4(randomRotation(random), translation));
+
+		LM_::Mat4 scaled = rigid.back();
+		for (int column = 0; column < 3; column++)
+		{
+			for (int row = 0; row < 3; row++)
+			{
+				scaled[column][row] *= 1.f + 0.5f * unit(random);
+			}
+		}
+		affine.push_back(scaled);
+
+		LM_::Mat4 any = scaled;
+		for (int column = 0; column < 4; column++)
+		{
+			any[column][3] = column == 3 ? 1.f + 0.5f * unit(random) : 0.1f * unit(random);
+		}
+		general.push_back(any);
+	}
+
+	std::vector<LM_::Mat4> inverses(rigid.size());
+	LM_::invert(general.data(), inverses.data(), general.size());
+	double residual = maxResidual(general, inverses);
+	check(residual < 1e-3, "invert", level, residual);
+
+	LM_::invertAffine(affine.data(), inverses.data(), affine.size());
+	residual = maxResidual(affine, inverses);
+	check(residual < 1e-3, "invertAffine", level, residual);
+
+	LM_::invertRigid(rigid.data(), inverses.data(), rigid.size());
+	residual = maxResidual(rigid, inverses);
+	check(residual < 1e-3, "invertRigid", level, residual);
+
+	for (size_t index = 0; index < general.size(); index++)
+	{
+		inverses[index] = general[index].GetInverse();
+	}
+	residual = maxResidual(general, inverses);
+	check(residual < 1e-3, "GetInverse", level, residual);
+}
+
+// Vertices in structure of arrays, as SkinnedMesh stores them
+struct Vertices
+{
+	explicit Vertices(size_t count)
+	{
+		for (std::vector<float>& stream : m_floats)
+		{
+			stream.resize(count);
+		}
+		for (std::vector<int32_t>& stream : m_boneIndices)
+		{
+			stream.resize(count);
+		}
+	}
+
+	LM_::ConstSkinningVertices getStreams() const
+	{
+		LM_::ConstSkinningVertices streams;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			streams.m_positions[axis] = m_floats[axis].data();
+			streams.m_normals[axis] = m_floats[3 + axis].data();
+		}
+		for (int influence = 0; influence < 4; influence++)
+		{
+			streams.m_boneIndices[influence] = m_boneIndices[influence].data();
+			streams.m_boneWeights[influence] = m_floats[6 + influence].data();
+		}
+		return streams;
+	}
+
+	std::vector<float>	 m_floats[10]; // Positions, normals and weights
+	std::vector<int32_t> m_boneIndices[4];
+};
+
+struct SkinnedStreams
+{
+	explicit SkinnedStreams(size_t count)
+	{
+		for (std::vector<float>& stream : m_floats)
+		{
+			stream.resize(count);
+		}
+	}
+
+	LM_::SkinnedVertices getStreams()
+	{
+		LM_::SkinnedVertices streams;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			streams.m_positions[axis] = m_floats[axis].data();
+			streams.m_normals[axis] = m_floats[3 + axis].data();
+		}
+		return streams;
+	}
+
+	// Largest difference of the positions, and of the normals
+	double maxDifference(SkinnedStreams const& other, int firstStream) const
+	{
+		double difference = 0.0;
+		for (int stream = firstStream; stream < firstStream + 3; stream++)
+		{
+			for (size_t vertex = 0; vertex < m_floats[stream].size(); vertex++)
+			{
+				difference = std::max(difference, std::fabs(double(m_floats[stream][vertex]) - other.m_floats[stream][vertex]));
+			}
+		}
+		return difference;
+	}
+
+	std::vector<float> m_floats[6];
+};
+
+// Dual quaternion and matrix skinning agree on rigidly bound vertices, and every instruction set matches the scalar
+// path on blended ones
+void checkSkinning(LM_::SimdLevel level)
+{
+	constexpr size_t BONE_COUNT = 32;
+	constexpr size_t VERTEX_COUNT = 1027; // Not a multiple of any SIMD width
+
+	std::mt19937						  random(7);
+	std::uniform_real_distribution<float> unit(-1.f, 1.f);
+
+	std::vector<LM_::Vec3>		 positions(BONE_COUNT);
+	std::vector<LM_::Quaternion> rotations(BONE_COUNT);
+	for (size_t bone = 0; bone < BONE_COUNT; bone++)
+	{
+		positions[bone] = LM_::Vec3(unit(random) * 50.f, unit(random) * 50.f, unit(random) * 50.f);
+		rotations[bone] = randomRotation(random);
+	}
+	std::vector<LM_::Mat4>			 matrices(BONE_COUNT);
+	std::vector<LM_::DualQuaternion> dualQuaternions(BONE_COUNT);
+	for (size_t bone = 0; bone < BONE_COUNT; bone++)
+	{
+		LM_::ConstRigidTransforms single = { &positions[bone], &rotations[bone], 0 };
+		LM_::toAffineMat4(single, &matrices[bone], 1);
+		LM_::toDualQuaternions(single, &dualQuaternions[bone], 1);
+	}
+
+	Vertices rigid(VERTEX_COUNT), blended(VERTEX_COUNT);
+	for (size_t vertex = 0; vertex < VERTEX_COUNT; vertex++)
+	{
+		float normal[3] = { unit(random), unit(random), unit(random) + 2.f };
+		float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+		for (int axis = 0; axis < 3; axis++)
+		{
+			float position = unit(random) * 100.f;
+			rigid.m_floats[axis][vertex] = blended.m_floats[axis][vertex] = position;
+			rigid.m_floats[3 + axis][vertex] = blended.m_floats[3 + axis][vertex] = normal[axis] / length;
+		}
+
+		float weights[4] = { std::fabs(unit(random)) + 0.1f, std::fabs(unit(random)), std::fabs(unit(random)), 0.f };
+		float totalWeight = weights[0] + weights[1] + weights[2];
+		for (int influence = 0; influence < 4; influence++)
+		{
+			rigid.m_boneIndices[influence][vertex] = int32_t(vertex % BONE_COUNT);
+			rigid.m_floats[6 + influence][vertex] = influence == 0 ? 1.f : 0.f;
+			blended.m_boneIndices[influence][vertex] = int32_t(random() % BONE_COUNT);
+			blended.m_floats[6 + influence][vertex] = weights[influence] / totalWeight;
+		}
+	}
+
+	SkinnedStreams byMatrices(VERTEX_COUNT), byDualQuaternions(VERTEX_COUNT);
+	LM_::skin(rigid.getStreams(), matrices.data(), byMatrices.getStreams(), VERTEX_COUNT);
+	LM_::skin(rigid.getStreams(), dualQuaternions.data(), byDualQuaternions.getStreams(), VERTEX_COUNT);
+	double difference = byMatrices.maxDifference(byDualQuaternions, 0);
+	check(difference < 1e-3, "dual quaternion skinning positions", level, difference);
+	difference = byMatrices.maxDifference(byDualQuaternions, 3);
+	check(difference < 1e-4, "dual quaternion skinning normals", level, difference);
+
+	SkinnedStreams scalar(VERTEX_COUNT), simd(VERTEX_COUNT);
+	LM_::setSimdLevel(LM_::SimdLevel::E_SCALAR);
+	LM_::skin(blended.getStreams(), dualQuaternions.data(), scalar.getStreams(), VERTEX_COUNT);
+	LM_::setSimdLevel(level);
+	LM_::skin(blended.getStreams(), dualQuaternions.data(), simd.getStreams(), VERTEX_COUNT);
+	difference = std::max(scalar.maxDifference(simd, 0), scalar.maxDifference(simd, 3));
+	check(difference < 1e-3, "blended dual quaternion skinning", level, difference);
+
+	LM_::setSimdLevel(LM_::SimdLevel::E_SCALAR);
+	LM_::skin(blended.getStreams(), matrices.data(), scalar.getStreams(), VERTEX_COUNT);
+	LM_::setSimdLevel(level);
+	LM_::skin(blended.getStreams(), matrices.data(), simd.getStreams(), VERTEX_COUNT);
+	difference = std::max(scalar.maxDifference(simd, 0), scalar.maxDifference(simd, 3));
+	check(difference < 1e-3, "blended matrix skinning", level, difference);
+}
+
+// Known conversions, then every instruction set against the scalar path on random floats, bit for bit
+void checkHalfFloats(LM_::SimdLevel level)
+{
+	struct Conversion
+	{
+		float	 m_value;
+		uint16_t m_half;
+	};
+	const Conversion conversions[] = {
+		{ 0.f, 0x0000 },		  { -0.f, 0x8000 },		  { 1.f, 0x3C00 },		 { -2.f, 0xC000 },
+		{ 65504.f, 0x7BFF },	  { 65520.f, 0x7C00 },	  { -1e6f, 0xFC00 },	 { 0x1p-24f, 0x0001 },
+		{ 0x1p-14f, 0x0400 },	  { 0x1p-25f, 0x0000 },	  { 1.f + 0x1p-11f, 0x3C00 }, // Tie, rounded to even
+		{ 1.f + 0x3p-11f, 0x3C02 }, { 0.333333f, 0x3555 },
+	};
+
+	uint16_t halves[std::size(conversions)];
+	float	 values[std::size(conversions)];
+	for (size_t index = 0; index < std::size(conversions); index++)
+	{
+		values[index] = conversions[index].m_value;
+	}
+	LM_::toHalfFloats(values, halves, std::size(conversions));
+	for (size_t index = 0; index < std::size(conversions); index++)
+	{
+		check(halves[index] == conversions[index].m_half, "toHalfFloats known value", level, values[index]);
+	}
+
+	std::mt19937					   random(3);
+	std::uniform_int_distribution<int> exponent(-30, 20);
+	std::uniform_real_distribution<float> mantissa(-2.f, 2.f);
+	std::vector<float>					  randomValues(4099);
+	for (float& value : randomValues)
+	{
+		value = std::ldexp(mantissa(random), exponent(random));
+	}
+
+	std::vector<uint16_t> scalar(randomValues.size()), simd(randomValues.size());
+	LM_::setSimdLevel(LM_::SimdLevel::E_SCALAR);
+	LM_::toHalfFloats(randomValues.data(), scalar.data(), randomValues.size());
+	LM_::setSimdLevel(level);
+	LM_::toHalfFloats(randomValues.data(), simd.data(), randomValues.size());
+
+	size_t mismatchCount = 0;
+	for (size_t index = 0; index < randomValues.size(); index++)
+	{
+		mismatchCount += scalar[index] != simd[index];
+	}
+	check(mismatchCount == 0, "toHalfFloats against the scalar path", level, double(mismatchCount));
+}
+} // namespace
+
+int main()
+{
+	LM_::SimdLevel supportedLevel = LM_::getSupportedSimdLevel();
+	for (int level = 0; level <= int(supportedLevel); level++)
+	{
+		LM_::setSimdLevel(LM_::SimdLevel(level));
+		std::printf("Checking the %s batch functions\n", g_levelNames[level]);
+
+		checkInverses(LM_::SimdLevel(level));
+		checkSkinning(LM_::SimdLevel(level));
+		checkHalfFloats(LM_::SimdLevel(level));
+	}
+	LM_::setSimdLevel(supportedLevel);
+
+	std::printf("%d failed checks\n", g_failureCount);
+	return g_failureCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,142 @@
+// Builds a Skeleton from a .skel file whose children come before their parents and whose ik_ bones sit in the middle of
+// the source order, then checks the bones left out, the engine index mapping and localToModel against a naive recursive
+// composition. Returns EXIT_FAILURE if any check fails.
+#include "Engine.h"
+#include "HeadlessEngine.h"
+#include "Skeleton.h"
+#include "Transform.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+struct SourceBone
+{
+	const char* m_name;
+	int			m_parentIndex;
+};
+
+// Children before parents, and ik_ bones with a bone hanging below one of them
+const SourceBone g_sourceBones[] = {
+	{ "hand_l", 3 }, { "ik_foot_root", 5 }, { "ik_foot_l", 1 }, { "lowerarm_l", 4 }, { "upperarm_l", 5 }, { "root", -1 },
+	{ "spine", 5 },	 { "head", 6 },			{ "ik_hand_gun", 7 }, { "weapon", 8 },	  { "pelvis", 5 },
+};
+const int g_expectedBones[] = { 0, -1, -1, 1, 2, 3, 4, 5, -1, -1, 6 };
+
+int g_failureCount = 0;
+
+void check(bool condition, const char* test, double value)
+{
+	if (!condition)
+	{
+		std::printf("FAILED %s: %g\n", test, value);
+		g_failureCount++;
+	}
+}
+
+template <class T>
+void writeValue(std::ofstream& file, T value)
+{
+	file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// .skel layout of SkeletonFile, with identity bind transforms
+void writeSkeletonFile(std::string const& path)
+{
+	std::ofstream file(path, std::ios::binary);
+	writeValue(file, uint32_t(std::size(g_sourceBones)));
+	for (size_t index = 0; index < std::size(g_sourceBones); index++)
+	{
+		writeValue(file, uint32_t(strlen(g_sourceBones[index].m_name)));
+		file.write(g_sourceBones[index].m_name, strlen(g_sourceBones[index].m_name));
+		writeValue(file, int32_t(index));
+		writeValue(file, int32_t(g_sourceBones[index].m_parentIndex));
+	}
+	for (size_t index = 0; index < std::size(g_sourceBones); index++)
+	{
+		const float transform[10] = { 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f, 1.f, 1.f };
+		file.write(reinterpret_cast<const char*>(transform), sizeof(transform));
+	}
+}
+
+Transform naiveModelTransform(Skeleton const& skeleton, std::vector<Transform> const& localTransforms, int bone)
+{
+	int parent = skeleton.m_Bones[bone].m_parentIndex;
+	return parent == -1 ? localTransforms[bone]
+						: localTransforms[bone] * naiveModelTransform(skeleton, localTransforms, parent);
+}
+} // namespace
+
+int main()
+{
+	std::filesystem::path directory = std::filesystem::temp_directory_path();
+	std::string			  skeletonName = "SkeletonTests" + std::to_string(std::random_device()()) + ".skel";
+	writeSkeletonFile((directory / skeletonName).string());
+
+	std::string		 resourceDirectory = (directory / "").string();
+	HeadlessSettings settings = HeadlessGetSettings();
+	settings.m_resourceDirectory = resourceDirectory.c_str();
+	settings.m_skeletonName = skeletonName.c_str();
+	HeadlessSetSettings(settings);
+
+	Skeleton skeleton(GetSkeletonBoneCount());
+	std::filesystem::remove(directory / skeletonName);
+
+	check(skeleton.m_boneCount == 7, "kept bone count", double(skeleton.m_boneCount));
+	check(!skeleton.isInSourceOrder(), "isInSourceOrder with ik_ bones in the middle", 1.0);
+	check(skeleton.m_sourceToBone.size() == std::size(g_sourceBones), "m_sourceToBone size",
+		  double(skeleton.m_sourceToBone.size()));
+	for (size_t source = 0; source < skeleton.m_sourceToBone.size(); source++)
+	{
+		int bone = skeleton.m_sourceToBone[source];
+		check(bone == g_expectedBones[source], "m_sourceToBone", double(source));
+		if (bone == -1)
+		{
+			continue;
+		}
+
+		Bone const& kept = skeleton.m_Bones[bone];
+		int			sourceParent = g_sourceBones[source].m_parentIndex;
+		check(kept.m_sourceIndex == int(source), "m_sourceIndex", double(source));
+		check(strcmp(kept.m_Name, g_sourceBones[source].m_name) == 0, "bone name", double(source));
+		check(kept.m_parentIndex == (sourceParent == -1 ? -1 : skeleton.m_sourceToBone[sourceParent]), "parent index",
+			  double(source));
+	}
+
+	std::mt19937						  random(11);
+	std::uniform_real_distribution<float> unit(-1.f, 1.f);
+	std::vector<Transform>				  localTransforms(skeleton.m_boneCount);
+	for (Transform& transform : localTransforms)
+	{
+		LM_::Quaternion rotation(unit(random), unit(random), unit(random), unit(random) + 2.f);
+		transform = Transform(LM_::Vec3(unit(random), unit(random), unit(random)) * 10.f, rotation.toUnitQuaternion());
+	}
+
+	std::vector<Transform> modelTransforms(skeleton.m_boneCount);
+	skeleton.localToModel(localTransforms.data(), modelTransforms.data());
+	double error = 0.0;
+	for (size_t bone = 0; bone < skeleton.m_boneCount; bone++)
+	{
+		Transform		 expected = naiveModelTransform(skeleton, localTransforms, int(bone));
+		Transform const& model = modelTransforms[bone];
+		error = std::max(error, double((expected.m_Position - model.m_Position).magnitude()));
+		error = std::max(error, double(std::fabs(expected.m_Rotation.m_a - model.m_Rotation.m_a)));
+		error = std::max(error, double(std::fabs(expected.m_Rotation.m_b - model.m_Rotation.m_b)));
+		error = std::max(error, double(std::fabs(expected.m_Rotation.m_c - model.m_Rotation.m_c)));
+		error = std::max(error, double(std::fabs(expected.m_Rotation.m_d - model.m_Rotation.m_d)));
+	}
+	check(error < 1e-4, "localToModel against the recursive composition", error);
+
+	std::printf("%d failed checks\n", g_failureCount);
+	return g_failureCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}